@@ -0,0 +1,703 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <memory>
+#include <optional>
+
+#include "96m4.h"
+#include "stb_image_write.h"
+
+#include "../examples/games/pong.hpp"
+#include "../examples/games/pong_batch.hpp"
+#include "../examples/games/dodge_batch.hpp"
+
+using namespace m964;
+
+// Usage: 96m4_bench [--filter <substring>] [--min-time <seconds>] [--json <file>] [--baseline <file>] [--tolerance <fraction>] [--perf]
+//
+// Every benchmark reports a rate (higher is better). --json writes the results, --baseline compares against a
+// previous --json file and exits with 1 if any benchmark got slower than the tolerance allows. --perf adds hardware
+// counters of the benchmark thread and, for the GA epochs, the per-region counters of all threads.
+
+struct BenchmarkOptions {
+    std::string filter = "";
+    double min_time = 0.25;
+    std::string json_file = "";
+    std::string baseline_file = "";
+    double tolerance = 0.10;
+    bool perf = false;
+};
+
+struct BenchmarkResult {
+    std::string name;
+    std::string unit;
+    std::uint64_t iterations;
+    double seconds;
+    double rate;
+
+    std::optional<PerfSample> counters = std::nullopt;
+    std::string regions_json = "";
+};
+
+class BenchmarkRunner {
+    private:
+        BenchmarkOptions options;
+        std::vector<BenchmarkResult> results;
+        std::unique_ptr<PerfCounterGroup> counters;
+
+    public:
+        explicit BenchmarkRunner(const BenchmarkOptions& options) : options(options) {
+            if (options.perf) {
+                counters = std::make_unique<PerfCounterGroup>();
+                if (!counters->available())
+                    std::cerr << "Warning: perf_event_open is unavailable, reporting wall-clock time only." << std::endl;
+            }
+        }
+
+        [[nodiscard]] auto perf() const -> bool {
+            return options.perf;
+        }
+
+        [[nodiscard]] auto enabled(const std::string& name) const -> bool {
+            return options.filter.empty() || name.find(options.filter) != std::string::npos;
+        }
+
+        // Repeats `body` until min_time has passed, `items` is the work done by one call (cells, evaluations, ...)
+        auto run(const std::string& name, const std::string& unit, const double& items, const std::function<void()>& body) -> void {
+            if (!enabled(name))
+                return;
+
+            body(); // warm up caches and allocations
+
+            std::uint64_t iterations = 0;
+            auto batch = std::uint64_t{1};
+            auto elapsed = 0.0;
+
+            // Rate of the fastest batch, the minimum is the least noisy estimate on a shared machine
+            auto best_rate = 0.0;
+
+            if (counters)
+                counters->start();
+
+            while (elapsed < options.min_time) {
+                const auto start = std::chrono::steady_clock::now();
+                for (std::uint64_t i = 0; i < batch; ++i)
+                    body();
+                const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+                elapsed += seconds;
+                iterations += batch;
+                best_rate = std::max(best_rate, static_cast<double>(batch) * items / std::max(seconds, 1e-9));
+
+                if (seconds < options.min_time / 10.0)
+                    batch *= 2;
+            }
+
+            auto result = BenchmarkResult{ name, unit, iterations, elapsed, best_rate };
+            if (counters)
+                result.counters = counters->stop();
+
+            record(result);
+        }
+
+        auto record(const BenchmarkResult& result) -> void {
+            results.push_back(result);
+            std::printf("%-48s %14.4g %-12s (%llu iterations, %.3f s)", result.name.c_str(), result.rate, result.unit.c_str(),
+                static_cast<unsigned long long>(result.iterations), result.seconds);
+
+            if (result.counters && result.counters->hardware) {
+                const auto calls = static_cast<double>(result.iterations);
+                std::printf(" IPC %.2f, L1D misses/iter %.4g, LLC misses/iter %.4g", result.counters->ipc(),
+                    static_cast<double>(result.counters->l1d_misses) / calls, static_cast<double>(result.counters->llc_misses) / calls);
+            }
+
+            std::printf("\n");
+            std::fflush(stdout);
+        }
+
+        [[nodiscard]] auto get_results() const -> const std::vector<BenchmarkResult>& {
+            return results;
+        }
+};
+
+auto write_json(const std::string& file_name, const std::vector<BenchmarkResult>& results) -> bool {
+    auto stream = std::ofstream(file_name, std::ios::trunc);
+    if (!stream)
+        return false;
+
+    stream << "{\n  \"hardware_concurrency\": " << std::thread::hardware_concurrency() << ",\n  \"results\": [\n";
+
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto& result = results[i];
+        char line[512];
+        std::snprintf(line, sizeof(line), "    {\"name\": \"%s\", \"unit\": \"%s\", \"iterations\": %llu, \"seconds\": %.6f, \"rate\": %.6g",
+            result.name.c_str(), result.unit.c_str(), static_cast<unsigned long long>(result.iterations), result.seconds, result.rate);
+        stream << line;
+
+        if (result.counters)
+            stream << ", \"perf\": " << to_json(*result.counters);
+
+        if (!result.regions_json.empty())
+            stream << ", \"regions\": " << result.regions_json;
+
+        stream << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+
+    stream << "  ]\n}\n";
+    return static_cast<bool>(stream);
+}
+
+// Reads the name and rate of every result written by write_json, one result object per line
+auto read_json(const std::string& file_name) -> std::map<std::string, double> {
+    auto rates = std::map<std::string, double>{};
+    auto stream = std::ifstream(file_name);
+    auto line = std::string{};
+
+    const auto string_field = [](const std::string& text, const std::string& key) -> std::string {
+        const auto start = text.find("\"" + key + "\": \"");
+        if (start == std::string::npos)
+            return "";
+
+        const auto begin = start + key.size() + 5;
+        return text.substr(begin, text.find('"', begin) - begin);
+    };
+
+    while (std::getline(stream, line)) {
+        const auto name = string_field(line, "name");
+        const auto rate = line.find("\"rate\": ");
+        if (name.empty() || rate == std::string::npos)
+            continue;
+
+        rates[name] = std::strtod(line.c_str() + rate + 8, nullptr);
+    }
+
+    return rates;
+}
+
+auto compare_with_baseline(const std::vector<BenchmarkResult>& results, const BenchmarkOptions& options) -> bool {
+    const auto baseline = read_json(options.baseline_file);
+    if (baseline.empty()) {
+        std::cerr << "Error: No results in baseline " << options.baseline_file << std::endl;
+        return false;
+    }
+
+    auto regressions = 0;
+    std::printf("\n%-48s %12s %12s %9s\n", "Benchmark", "Baseline", "Current", "Change");
+
+    for (const auto& result : results) {
+        const auto it = baseline.find(result.name);
+        if (it == baseline.end() || it->second <= 0.0)
+            continue;
+
+        const auto change = result.rate / it->second - 1.0;
+        const auto regressed = change < -options.tolerance;
+        regressions += regressed ? 1 : 0;
+
+        std::printf("%-48s %12.4g %12.4g %+8.1f%%%s\n", result.name.c_str(), it->second, result.rate, change * 100.0, regressed ? "  REGRESSION" : "");
+    }
+
+    std::printf("\n%d regression(s) beyond %.0f%%\n", regressions, options.tolerance * 100.0);
+    return regressions == 0;
+}
+
+auto random_model(const std::size_t& width, const std::size_t& height) -> Model {
+    auto model = Model(width, height);
+    initialize_model(model, 0.5f);
+    model.get_old_state().fill([]() { return rand_float(0.0f, 1.0f); });
+    return model;
+}
+
+auto bench_steps(BenchmarkRunner& runner) -> void {
+    for (const std::size_t size : { 4, 16, 64, 256, 1024, 2048 }) {
+        const auto dims = std::to_string(size) + "x" + std::to_string(size);
+        const auto cells = static_cast<double>(size * size);
+
+        auto model = random_model(size, size);
+
+        runner.run("calculate_state/" + dims, "cells/s", cells, [&]() {
+            calculate_state(model.get_new_state(), model.get_old_state(), model.weights);
+        });
+
+        runner.run("simulate_step_with_biases/" + dims, "cells/s", cells, [&]() {
+            model.simulate_step_with_biases();
+        });
+    }
+}
+
+// One readout cell after 24 steps, a full rollout against its light cone
+auto bench_light_cone(BenchmarkRunner& runner) -> void {
+    constexpr std::size_t steps = 24;
+
+    for (const std::size_t size : { 32, 64, 256 }) {
+        const auto dims = std::to_string(size) + "x" + std::to_string(size);
+        const auto readout = CellRegion { size / 2, size / 2 + 1, size / 2, size / 2 + 1 };
+
+        auto model = random_model(size, size);
+
+        runner.run("rollout/full/" + dims, "rollouts/s", 1.0, [&]() {
+            for (std::size_t t = 0; t < steps; ++t)
+                model.simulate_step_with_biases();
+        });
+
+        runner.run("rollout/light_cone/" + dims, "rollouts/s", 1.0, [&]() {
+            simulate_steps_for_readout(model, readout, steps);
+        });
+    }
+}
+
+auto bench_layer(BenchmarkRunner& runner) -> void {
+    constexpr std::size_t size = 256;
+    const auto cells = static_cast<double>(size * size);
+
+    auto layer = Layer(size, size);
+
+    runner.run("layer_fill/value", "cells/s", cells, [&]() {
+        layer.fill(0.5f);
+    });
+
+    runner.run("layer_fill/generator", "cells/s", cells, [&]() {
+        layer.fill([]() { return 0.5f; });
+    });
+
+    runner.run("layer_fill/coordinates", "cells/s", cells, [&]() {
+        layer.fill([](const std::size_t& x, const std::size_t& y) { return static_cast<float>((x ^ y) & 1); });
+    });
+
+    runner.run("layer_apply/relu", "cells/s", cells, [&]() {
+        layer.apply(ReluValue{});
+    });
+
+    auto bitmap = std::vector<std::int32_t>(size * size);
+    for (std::size_t i = 0; i < bitmap.size(); ++i)
+        bitmap[i] = static_cast<std::int32_t>(i % 3 == 0);
+
+    runner.run("layer_fill/bitmap_lambda", "cells/s", cells, [&]() {
+        layer.fill([&](const std::size_t& x, const std::size_t& y) { return bitmap[x + y * size] ? 1.0f : 0.0f; });
+    });
+
+    runner.run("load_bitmap/int32", "cells/s", cells, [&]() {
+        load_bitmap(layer, bitmap.data(), size, size, size);
+    });
+}
+
+auto bench_mutation(BenchmarkRunner& runner) -> void {
+    constexpr std::size_t size = 256;
+    const auto kernels = static_cast<double>(size * size);
+
+    auto model = random_model(size, size);
+
+    runner.run("kernel_offset/256x256", "kernels/s", kernels, [&]() {
+        model.weights.apply(KernelOffset{ -0.01f, 0.01f });
+    });
+
+    runner.run("mutate_model/256x256", "kernels/s", kernels, [&]() {
+        mutate_model(model, 0.01f);
+    });
+
+    // An ES style update of every parameter, one pass over the flat parameter buffer
+    auto direction = std::vector<float>(model.parameters().size(), 0.001f);
+
+    runner.run("parameters/axpy/256x256", "kernels/s", kernels, [&]() {
+        active_kernels().add_scaled(model.parameters().data(), direction.data(), 0.5f, direction.size());
+    });
+
+    // A population of 100 candidates with and without their own simulation states
+    auto parameters_only = model;
+    parameters_only.release_states();
+
+    runner.run("population/with_states/256x256", "candidates/s", 100.0, [&]() {
+        const auto population = std::vector<Model>(100, model);
+    });
+
+    runner.run("population/parameters_only/256x256", "candidates/s", 100.0, [&]() {
+        const auto population = std::vector<Model>(100, parameters_only);
+    });
+
+    // Producing a candidate from a parent and bringing it into a worker model, whole models against shared tiles
+    auto parent = model;
+    auto worker = model;
+
+    runner.run("candidate/copy_mutate_model/256x256", "candidates/s", 1.0, [&]() {
+        worker = parent;
+        mutate_model(worker, 0.01f);
+    });
+
+    const auto parent_blocks = BlockParameters(parent);
+    auto worker_blocks = parent_blocks;
+
+    runner.run("candidate/block_parameters/256x256", "candidates/s", 1.0, [&]() {
+        auto blocks = parent_blocks;
+        blocks.mutate_random_block(0.01f);
+        blocks.write_changed_to(worker, worker_blocks);
+        worker_blocks = std::move(blocks);
+    });
+
+    // 16 steps against a target, a full evaluation against the incremental one of an 8x8 tile mutation
+    auto target = Layer(size, size);
+    target.fill([]() { return rand_float(0.0f, 1.0f); });
+
+    const auto spec = EvaluationSpec {
+        .samples = { EvaluationSample { .target = target } },
+        .n_evolution_steps = 16
+    };
+
+    auto evaluator = IncrementalEvaluator(spec, model);
+
+    runner.run("evaluate/full/256x256", "evals/s", 1.0, [&]() {
+        auto child = model;
+        mutate_model_tile(child, 0.01f, 8, 8);
+        evaluate(child, spec);
+    });
+
+    runner.run("evaluate/incremental_tile/256x256", "evals/s", 1.0, [&]() {
+        auto child = model;
+        const auto tile = mutate_model_tile(child, 0.01f, 8, 8);
+        evaluator.evaluate(child, tile);
+    });
+}
+
+auto bench_parallel_executor(BenchmarkRunner& runner) -> void {
+    constexpr std::size_t population = 64;
+    constexpr std::size_t steps = 16;
+
+    auto models = std::vector<Model>{};
+    for (std::size_t i = 0; i < population; ++i)
+        models.push_back(random_model(32, 32));
+
+    const auto hardware_threads = std::max(1u, std::thread::hardware_concurrency());
+
+    // Powers of two below the hardware concurrency, then the hardware concurrency itself
+    auto thread_counts = std::vector<unsigned int>{};
+    for (unsigned int threads = 1; threads < hardware_threads; threads *= 2)
+        thread_counts.push_back(threads);
+    thread_counts.push_back(hardware_threads);
+
+    for (const auto threads : thread_counts) {
+        const auto executor = ParallelExecutor(threads);
+
+        runner.run("parallel_executor/threads_" + std::to_string(threads), "evals/s", static_cast<double>(population), [&]() {
+            executor.execute(models.begin(), models.end(), [&](Model& model) {
+                for (std::size_t t = 0; t < steps; ++t)
+                    model.simulate_step_with_biases();
+            });
+        });
+    }
+}
+
+// Environment cost of a population of games: step, render into the model input and move by the oracle
+auto bench_environments(BenchmarkRunner& runner) -> void {
+    constexpr std::size_t games = 100;
+    constexpr std::size_t frames = 500;
+    const auto items = static_cast<double>(games * frames);
+
+    auto models = std::vector<Model>{};
+    for (std::size_t i = 0; i < games; ++i)
+        models.emplace_back(32, 16);
+
+    runner.run("env/pong_game", "frames/s", items, [&]() {
+        for (std::size_t i = 0; i < games; ++i) {
+            auto game = PongGame();
+
+            for (std::size_t frame = 0; frame < frames && !game.is_game_over(); ++frame) {
+                game.simulate_frame();
+
+                load_bitmap(models[i].get_old_state(), game.screen);
+
+                const auto expected = game.paddle_prediction();
+                if (expected < 0.5f) game.paddle_left();
+                if (expected > 0.5f) game.paddle_right();
+            }
+        }
+    });
+
+    auto pong = PongBatch(games);
+    auto dodge = DodgeBatch(games);
+    auto actions = std::vector<float>(games);
+
+    runner.run("env/pong_batch", "frames/s", items, [&]() {
+        pong.reset();
+
+        for (std::size_t frame = 0; frame < frames; ++frame) {
+            pong.simulate_frame();
+
+            for (std::size_t i = 0; i < games; ++i)
+                pong.render(i, models[i].get_old_state());
+
+            pong.paddle_predictions(actions.data());
+            pong.move_paddles(actions.data());
+        }
+    });
+
+    for (std::size_t i = 0; i < games; ++i)
+        models[i] = Model(12, 32);
+
+    runner.run("env/dodge_batch", "frames/s", items, [&]() {
+        dodge.reset();
+
+        for (std::size_t frame = 0; frame < frames; ++frame) {
+            dodge.simulate_frame();
+
+            for (std::size_t i = 0; i < games; ++i)
+                dodge.render(i, models[i].get_old_state());
+
+            dodge.move_paddles(actions.data());
+        }
+    });
+}
+
+// The same pong cost once as a plain callback per candidate and once as coroutine episodes, batched per thread
+auto pong_episode(Model& model) -> Episode {
+    auto game = PongGame();
+    auto cost = 0.0f;
+
+    for (auto score = 0; score <= 100 && !game.is_game_over(); ++score) {
+        game.simulate_frame();
+        load_bitmap(model.get_old_state(), game.screen);
+
+        co_await step_model(model, 24);
+
+        const auto expected = game.paddle_prediction();
+        cost += std::fabs(expected - co_await read_probe(model, 16, 8));
+
+        if (expected < 0.5f) game.paddle_left();
+        if (expected > 0.5f) game.paddle_right();
+    }
+
+    co_return cost;
+}
+
+auto bench_episodes(BenchmarkRunner& runner) -> void {
+    constexpr std::size_t population = 64;
+
+    auto models = std::vector<Model>{};
+    for (std::size_t i = 0; i < population; ++i)
+        models.push_back(random_model(32, 16));
+
+    const auto executor = ParallelExecutor();
+    const auto cost = episode_cost(pong_episode);
+
+    runner.run("episodes/pong_callbacks", "evals/s", static_cast<double>(population), [&]() {
+        executor.execute(models.begin(), models.end(), [&](Model& model) {
+            cost(model);
+        });
+    });
+
+    runner.run("episodes/pong_scheduler", "evals/s", static_cast<double>(population), [&]() {
+        evaluate_episodes(models, pong_episode);
+    });
+}
+
+// Full GA epochs, target_cost_threshold is unreachable so every run does exactly max_epochs epochs
+auto bench_training_epochs(BenchmarkRunner& runner, const std::string& name, GeneticAlgorithmTrainingParameters parameters, const std::function<float(Model&)>& cost) -> void {
+    if (!runner.enabled(name))
+        return;
+
+    parameters.target_cost_threshold = -1.0f;
+    parameters.print_interval_epochs = parameters.max_epochs + 1;
+
+    // Scoped regions read the counters around every step, so they are only enabled for the macro benchmarks
+    set_perf_counters_enabled(runner.perf());
+    reset_perf_regions();
+
+    const auto start = std::chrono::steady_clock::now();
+    genetic_algorithm_training_hyper(cost, parameters);
+    const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    set_perf_counters_enabled(false);
+
+    auto result = BenchmarkResult{ name, "epochs/s", 1, seconds, static_cast<double>(parameters.max_epochs) / seconds };
+
+    if (runner.perf()) {
+        const auto regions = collect_perf_regions();
+        auto json = std::ostringstream{};
+
+        json << "{";
+        for (std::size_t i = 0; i < PERF_REGION_COUNT; ++i) {
+            const auto region = static_cast<PerfRegion>(i);
+            json << (i > 0 ? ", " : "") << "\"" << perf_region_name(region) << "\": " << to_json(regions[i]);
+
+            if (regions[i].hardware)
+                std::printf("    %-12s IPC %.2f, %llu calls, %.3f s, L1D misses %llu, LLC misses %llu, branch misses %llu\n", perf_region_name(region), regions[i].ipc(),
+                    static_cast<unsigned long long>(regions[i].calls), regions[i].seconds, static_cast<unsigned long long>(regions[i].l1d_misses),
+                    static_cast<unsigned long long>(regions[i].llc_misses), static_cast<unsigned long long>(regions[i].branch_misses));
+            else
+                std::printf("    %-12s %llu calls, %.3f s\n", perf_region_name(region), static_cast<unsigned long long>(regions[i].calls), regions[i].seconds);
+        }
+        json << "}";
+
+        result.regions_json = json.str();
+    }
+
+    runner.record(result);
+}
+
+auto bench_training(BenchmarkRunner& runner) -> void {
+    {
+        auto parameters = GeneticAlgorithmTrainingParameters {
+            .model_width = 4,
+            .model_height = 4,
+            .n_evolution_steps = 16,
+            .population_size = 100,
+            .initial_mutation_strength = 0.1f,
+            .max_epochs = 50
+        };
+
+        bench_training_epochs(runner, "ga_epoch/math", parameters, [&](Model& model) {
+            auto cost = 0.0f;
+
+            for (auto point = -0.8f; point < 0.3f; point += 0.025f) {
+                model.reset_states();
+
+                for (std::size_t t = 0; t < parameters.n_evolution_steps; ++t) {
+                    model.get_old_state()(0, 0) = point;
+                    model.simulate_step_with_biases();
+                }
+
+                const auto difference = model.get_new_state()(3, 3) - (2 * point * point + point + 0.25f);
+                cost += difference * difference;
+            }
+
+            return cost;
+        });
+    }
+
+    {
+        auto parameters = GeneticAlgorithmTrainingParameters {
+            .model_width = 64,
+            .model_height = 64,
+            .n_evolution_steps = 16,
+            .population_size = 32,
+            .initial_mutation_strength = 0.1f,
+            .max_epochs = 10
+        };
+
+        // Synthetic ring instead of an image file, keeps the suite self-contained
+        auto target = Layer(parameters.model_width, parameters.model_height);
+        target.fill([](const std::size_t& x, const std::size_t& y) {
+            const auto distance = std::hypot(static_cast<float>(x) - 32.0f, static_cast<float>(y) - 32.0f);
+            return distance > 12.0f && distance < 20.0f ? 1.0f : 0.0f;
+        });
+
+        bench_training_epochs(runner, "ga_epoch/image", parameters, [&](Model& model) {
+            model.reset_states();
+            model.get_old_state().fill(1.0f);
+
+            auto cost = 0.0f;
+            for (std::size_t t = 0; t < parameters.n_evolution_steps; ++t)
+                cost += simulate_step_with_loss(model, target, LossKind::SquaredError, LossReduction::Sum);
+
+            return cost;
+        });
+    }
+
+    {
+        auto parameters = GeneticAlgorithmTrainingParameters {
+            .model_width = 32,
+            .model_height = 16,
+            .n_evolution_steps = 24,
+            .population_size = 10,
+            .initial_mutation_strength = 1.0f,
+            .max_epochs = 10
+        };
+
+        bench_training_epochs(runner, "ga_epoch/pong", parameters, [&](Model& model) {
+            auto game = PongGame();
+            auto score = 0;
+            auto cost = 0.0f;
+
+            while (!game.is_game_over() && score <= 100) {
+                game.simulate_frame();
+
+                load_bitmap(model.get_old_state(), game.screen);
+
+                for (std::size_t t = 0; t < parameters.n_evolution_steps; ++t)
+                    model.simulate_step_with_biases();
+
+                const auto expected = game.paddle_prediction();
+                cost += std::fabs(expected - model.get_new_state()(16, 8));
+
+                if (expected < 0.5f) game.paddle_left();
+                if (expected > 0.5f) game.paddle_right();
+
+                ++score;
+            }
+
+            return cost;
+        });
+
+        // Same episodes, recorded once and replayed by every candidate
+        auto episode = ObservationTrajectory(PongBatch::SCREEN_WIDTH, PongBatch::SCREEN_HEIGHT);
+        auto game = PongBatch(1);
+        auto frame = Layer(PongBatch::SCREEN_WIDTH, PongBatch::SCREEN_HEIGHT);
+
+        for (auto score = 0; score <= 100 && !game.is_game_over(0); ++score) {
+            game.simulate_frame();
+            game.render(0, frame);
+
+            const auto expected = game.paddle_prediction(0);
+            episode.record(frame, { &expected, 1 });
+            game.move_paddles(&expected);
+        }
+
+        bench_training_epochs(runner, "ga_epoch/pong_replay", parameters, [&](Model& model) {
+            return replay_trajectory(model, episode, parameters.n_evolution_steps, [](const Layer& state, std::span<const float> targets) {
+                return std::fabs(targets[0] - state(16, 8));
+            });
+        });
+    }
+}
+
+auto main(const int argc, char* argv[]) -> std::int32_t {
+    auto options = BenchmarkOptions{};
+
+    for (int i = 1; i < argc; ++i) {
+        const auto argument = std::string(argv[i]);
+        const auto has_value = i + 1 < argc;
+
+        if (argument == "--filter" && has_value) options.filter = argv[++i];
+        else if (argument == "--min-time" && has_value) options.min_time = std::atof(argv[++i]);
+        else if (argument == "--json" && has_value) options.json_file = argv[++i];
+        else if (argument == "--baseline" && has_value) options.baseline_file = argv[++i];
+        else if (argument == "--tolerance" && has_value) options.tolerance = std::atof(argv[++i]);
+        else if (argument == "--perf") options.perf = true;
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--filter <substring>] [--min-time <seconds>] [--json <file>] [--baseline <file>] [--tolerance <fraction>] [--perf]" << std::endl;
+            return 1;
+        }
+    }
+
+    // Same candidates and games on every run
+    seed_random(964);
+
+    auto runner = BenchmarkRunner(options);
+
+    bench_steps(runner);
+    bench_light_cone(runner);
+    bench_layer(runner);
+    bench_mutation(runner);
+    bench_parallel_executor(runner);
+    bench_environments(runner);
+    bench_episodes(runner);
+    bench_training(runner);
+
+    if (!options.json_file.empty() && !write_json(options.json_file, runner.get_results())) {
+        std::cerr << "Error: Could not write " << options.json_file << std::endl;
+        return 1;
+    }
+
+    if (!options.baseline_file.empty() && !compare_with_baseline(runner.get_results(), options))
+        return 1;
+
+    return 0;
+}
@@ -27,9 +27,8 @@ auto model_cost(Model &model) -> size_t {
         auto o = i % 2;
         auto n = (i + 1) % 2;
 
-        auto &old_state = model.states[o].fill([&](const auto &x, const auto &y) {
-            return game.screen[y][x] ? 1.0f : 0.0f;
-        });
+        auto &old_state = model.states[o];
+        load_bitmap(old_state, game.screen);
 
         auto &new_state = model.states[n];
         auto &weights = model.weights;
@@ -69,6 +68,10 @@ auto model_demonstrate(Model& model) -> void {
 
     auto game = DodgeGame();
 
+    // Watch with `live_viewer state` and `live_viewer game`
+    auto state_feed = LiveFeedPublisher("state", model.width, model.height);
+    auto game_feed = LiveFeedPublisher("game", model.width, model.height);
+
     std::int32_t i = 0;
     while (!game.is_game_over()) {
         game.simulate_frame();
@@ -76,9 +79,10 @@ auto model_demonstrate(Model& model) -> void {
         auto o = i % 2;
         auto n = (i + 1) % 2;
 
-        auto &old_state = model.states[o].fill([&](const auto &x, const auto &y) {
-            return game.screen[y][x] ? 1.0f : 0.0f;
-        });
+        auto &old_state = model.states[o];
+        load_bitmap(old_state, game.screen);
+
+        game_feed.publish(old_state);
 
         auto &new_state = model.states[n];
 
@@ -95,15 +99,13 @@ auto model_demonstrate(Model& model) -> void {
             new_state.apply(NormalizeValue());
             new_state.apply(ReluValue<float>{});
 
-            export_state_as_image("state.png", new_state);
+            state_feed.publish(new_state);
             std::this_thread::sleep_for(std::chrono::milliseconds(50));
             ++i;
         }
 
         // if (new_state(16, 8) < 0.5f) game.paddle_left();
         // if (new_state(16, 8) > 0.5f) game.paddle_right();
-
-        game.display_buffer();
     }
 }
 
@@ -24,6 +24,9 @@ auto main() -> std::int32_t {
         return Kernel { -0.296, 0.304, -0.637, -0.226, -0.936, -0.051, 0.547, -0.034, 0.323}; 
     });
    
+    // Watch with `live_viewer state`
+    auto state_feed = LiveFeedPublisher("state", 128u, 128u);
+
     for(auto i = 0; i < 1000000; ++i) {
         const auto o = i % 2;
         const auto n = (i + 1) % 2;
@@ -39,7 +42,7 @@ auto main() -> std::int32_t {
             if(value < 0.0f) value = 0.0f;
         });
 
-        export_state_as_image("state.png", new_state);
+        state_feed.publish(new_state);
         std::this_thread::sleep_for(std::chrono::milliseconds(50));
     }
 
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+#include "layer.h"
+
+// DodgeGame for a whole population in structure-of-arrays form, see PongBatch. The screen is 12 cells wide and
+// 32 high like DodgeGame::screen. The paddle chases the ball on its own and the player can push it away.
+class DodgeBatch {
+    public:
+        static constexpr std::int32_t SCREEN_WIDTH = 12;
+        static constexpr std::int32_t SCREEN_HEIGHT = 32;
+
+        static constexpr std::int32_t PADDLE_WIDTH = 8;
+        static constexpr std::int32_t PADDLE_HEIGHT = 1;
+        static constexpr std::int32_t PADDLE_Y = SCREEN_HEIGHT - 2;
+
+        static constexpr std::int32_t BALL_SIZE = 1;
+
+        std::vector<std::int32_t> paddle_x;
+        std::vector<std::int32_t> ball_x;
+        std::vector<std::int32_t> ball_y;
+        std::vector<std::int32_t> ball_vx;
+        std::vector<std::int32_t> ball_vy;
+        std::vector<std::uint8_t> game_over;
+
+    private:
+        static auto draw(float* values, const std::size_t& width, const std::size_t& height, std::int32_t x, std::int32_t y, std::int32_t w, std::int32_t h) -> void {
+            const auto max_x = std::min<std::int32_t>(x + w, std::min<std::int32_t>(SCREEN_WIDTH, static_cast<std::int32_t>(width)));
+            const auto max_y = std::min<std::int32_t>(y + h, std::min<std::int32_t>(SCREEN_HEIGHT, static_cast<std::int32_t>(height)));
+
+            for (auto draw_y = std::max(y, 0); draw_y < max_y; ++draw_y)
+                for (auto draw_x = std::max(x, 0); draw_x < max_x; ++draw_x)
+                    values[draw_x + draw_y * static_cast<std::int32_t>(width)] = 1.0f;
+        }
+
+    public:
+        explicit DodgeBatch(const std::size_t& size)
+            : paddle_x(size), ball_x(size), ball_y(size), ball_vx(size), ball_vy(size), game_over(size) {
+            reset();
+        }
+
+        auto size() const -> std::size_t {
+            return paddle_x.size();
+        }
+
+        void reset() {
+            std::fill(paddle_x.begin(), paddle_x.end(), SCREEN_WIDTH / 2 - PADDLE_WIDTH / 2);
+            std::fill(ball_x.begin(), ball_x.end(), SCREEN_WIDTH / 2);
+            std::fill(ball_y.begin(), ball_y.end(), SCREEN_HEIGHT / 2);
+            std::fill(ball_vx.begin(), ball_vx.end(), 1);
+            std::fill(ball_vy.begin(), ball_vy.end(), -1);
+            std::fill(game_over.begin(), game_over.end(), 0);
+        }
+
+        auto is_game_over(const std::size_t& game) const -> bool {
+            return game_over[game] != 0;
+        }
+
+        auto running() const -> std::size_t {
+            return static_cast<std::size_t>(std::count(game_over.begin(), game_over.end(), 0));
+        }
+
+        // DodgeGame::simulate_frame plus the ball movement of PongGame, finished games keep their last frame
+        void simulate_frame() {
+            const auto count = size();
+
+            auto* __restrict px = paddle_x.data();
+            auto* __restrict bx = ball_x.data();
+            auto* __restrict by = ball_y.data();
+            auto* __restrict vx = ball_vx.data();
+            auto* __restrict vy = ball_vy.data();
+            auto* __restrict over = game_over.data();
+
+            for (std::size_t i = 0; i < count; ++i) {
+                const auto running = over[i] == 0;
+
+                const auto paddle_center = px[i] + PADDLE_WIDTH / 2;
+                const auto chase = static_cast<std::int32_t>(bx[i] > paddle_center) - static_cast<std::int32_t>(bx[i] < paddle_center);
+                const auto paddle = std::clamp(px[i] + chase, 0, SCREEN_WIDTH - PADDLE_WIDTH);
+
+                const auto x = bx[i] + vx[i];
+                const auto y = by[i] + vy[i];
+
+                auto dx = vx[i];
+                auto dy = vy[i];
+
+                dx = (x <= 0 || x >= SCREEN_WIDTH - BALL_SIZE) ? -dx : dx;
+                dy = y <= 0 ? -dy : dy;
+                dy = (y >= PADDLE_Y - BALL_SIZE && x >= paddle && x < paddle + PADDLE_WIDTH) ? -dy : dy;
+
+                px[i] = running ? paddle : px[i];
+                bx[i] = running ? x : bx[i];
+                by[i] = running ? y : by[i];
+                vx[i] = running ? dx : vx[i];
+                vy[i] = running ? dy : vy[i];
+                over[i] = static_cast<std::uint8_t>(!running || y > SCREEN_HEIGHT - 2);
+            }
+        }
+
+        // Below 0.5 pushes a paddle left, above 0.5 right
+        void move_paddles(const float* actions) {
+            const auto count = size();
+            auto* __restrict px = paddle_x.data();
+
+            for (std::size_t i = 0; i < count; ++i) {
+                const auto move = static_cast<std::int32_t>(actions[i] > 0.5f) - static_cast<std::int32_t>(actions[i] < 0.5f);
+                px[i] = std::clamp(px[i] + move, 0, SCREEN_WIDTH - PADDLE_WIDTH);
+            }
+        }
+
+        void render(const std::size_t& game, float* values, const std::size_t& width, const std::size_t& height) const {
+            std::fill(values, values + width * height, 0.0f);
+
+            draw(values, width, height, ball_x[game], ball_y[game], BALL_SIZE, BALL_SIZE);
+            draw(values, width, height, paddle_x[game], PADDLE_Y, PADDLE_WIDTH, PADDLE_HEIGHT);
+        }
+
+        void render(const std::size_t& game, m964::Layer& state) const {
+            render(game, state.data(), state.get_width(), state.get_height());
+        }
+};
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+#include "layer.h"
+
+// PongGame for a whole population: N games in structure-of-arrays form. A frame updates every running game in one
+// branch-free pass over the arrays, and render() writes a game straight into a model input state, so there is no
+// int32 screen to clear, draw and convert cell by cell.
+class PongBatch {
+    public:
+        static constexpr std::int32_t SCREEN_WIDTH = 32;
+        static constexpr std::int32_t SCREEN_HEIGHT = 16;
+
+        static constexpr std::int32_t PADDLE_WIDTH = 8;
+        static constexpr std::int32_t PADDLE_HEIGHT = 1;
+        static constexpr std::int32_t PADDLE_Y = SCREEN_HEIGHT - 2;
+
+        static constexpr std::int32_t BALL_SIZE = 1;
+
+        std::vector<std::int32_t> paddle_x;
+        std::vector<std::int32_t> ball_x;
+        std::vector<std::int32_t> ball_y;
+        std::vector<std::int32_t> ball_vx;
+        std::vector<std::int32_t> ball_vy;
+        std::vector<std::uint8_t> game_over;
+
+    private:
+        static auto draw(float* values, const std::size_t& width, const std::size_t& height, std::int32_t x, std::int32_t y, std::int32_t w, std::int32_t h) -> void {
+            const auto max_x = std::min<std::int32_t>(x + w, std::min<std::int32_t>(SCREEN_WIDTH, static_cast<std::int32_t>(width)));
+            const auto max_y = std::min<std::int32_t>(y + h, std::min<std::int32_t>(SCREEN_HEIGHT, static_cast<std::int32_t>(height)));
+
+            for (auto draw_y = std::max(y, 0); draw_y < max_y; ++draw_y)
+                for (auto draw_x = std::max(x, 0); draw_x < max_x; ++draw_x)
+                    values[draw_x + draw_y * static_cast<std::int32_t>(width)] = 1.0f;
+        }
+
+    public:
+        explicit PongBatch(const std::size_t& size)
+            : paddle_x(size), ball_x(size), ball_y(size), ball_vx(size), ball_vy(size), game_over(size) {
+            reset();
+        }
+
+        auto size() const -> std::size_t {
+            return paddle_x.size();
+        }
+
+        // Every game starts like a new PongGame
+        void reset() {
+            std::fill(paddle_x.begin(), paddle_x.end(), SCREEN_WIDTH / 2 - PADDLE_WIDTH / 2);
+            std::fill(ball_x.begin(), ball_x.end(), SCREEN_WIDTH / 2);
+            std::fill(ball_y.begin(), ball_y.end(), SCREEN_HEIGHT / 2);
+            std::fill(ball_vx.begin(), ball_vx.end(), 1);
+            std::fill(ball_vy.begin(), ball_vy.end(), -1);
+            std::fill(game_over.begin(), game_over.end(), 0);
+        }
+
+        auto is_game_over(const std::size_t& game) const -> bool {
+            return game_over[game] != 0;
+        }
+
+        auto running() const -> std::size_t {
+            return static_cast<std::size_t>(std::count(game_over.begin(), game_over.end(), 0));
+        }
+
+        // Same rules as PongGame::simulate_frame, finished games keep their last frame
+        void simulate_frame() {
+            const auto count = size();
+
+            auto* __restrict bx = ball_x.data();
+            auto* __restrict by = ball_y.data();
+            auto* __restrict vx = ball_vx.data();
+            auto* __restrict vy = ball_vy.data();
+            auto* __restrict over = game_over.data();
+            const auto* __restrict px = paddle_x.data();
+
+            for (std::size_t i = 0; i < count; ++i) {
+                const auto running = over[i] == 0;
+
+                const auto x = bx[i] + vx[i];
+                const auto y = by[i] + vy[i];
+
+                auto dx = vx[i];
+                auto dy = vy[i];
+
+                dx = (x <= 0 || x >= SCREEN_WIDTH - BALL_SIZE) ? -dx : dx;
+                dy = y <= 0 ? -dy : dy;
+                dy = (y >= PADDLE_Y - BALL_SIZE && x >= px[i] && x < px[i] + PADDLE_WIDTH) ? -dy : dy;
+
+                bx[i] = running ? x : bx[i];
+                by[i] = running ? y : by[i];
+                vx[i] = running ? dx : vx[i];
+                vy[i] = running ? dy : vy[i];
+                over[i] = static_cast<std::uint8_t>(!running || y > SCREEN_HEIGHT - 2);
+            }
+        }
+
+        auto paddle_prediction(const std::size_t& game) const -> float {
+            const auto paddle = 2 * paddle_x[game] + PADDLE_WIDTH; // Twice the paddle center, stays integer
+
+            if (2 * ball_x[game] > paddle)
+                return 1.0f;
+
+            if (2 * ball_x[game] < paddle)
+                return 0.0f;
+
+            return 0.5f;
+        }
+
+        void paddle_predictions(float* predictions) const {
+            const auto count = size();
+
+            for (std::size_t i = 0; i < count; ++i) {
+                const auto ball = 2 * ball_x[i];
+                const auto paddle = 2 * paddle_x[i] + PADDLE_WIDTH;
+
+                predictions[i] = ball > paddle ? 1.0f : (ball < paddle ? 0.0f : 0.5f);
+            }
+        }
+
+        // Below 0.5 moves a paddle left, above 0.5 right, like paddle_left() / paddle_right() of PongGame
+        void move_paddles(const float* actions) {
+            const auto count = size();
+            auto* __restrict px = paddle_x.data();
+
+            for (std::size_t i = 0; i < count; ++i) {
+                const auto move = static_cast<std::int32_t>(actions[i] > 0.5f) - static_cast<std::int32_t>(actions[i] < 0.5f);
+                px[i] = std::clamp(px[i] + move, 0, SCREEN_WIDTH - PADDLE_WIDTH);
+            }
+        }
+
+        void paddle_left(const std::size_t& game) {
+            paddle_x[game] = std::clamp(paddle_x[game] - 1, 0, SCREEN_WIDTH - PADDLE_WIDTH);
+        }
+
+        void paddle_right(const std::size_t& game) {
+            paddle_x[game] = std::clamp(paddle_x[game] + 1, 0, SCREEN_WIDTH - PADDLE_WIDTH);
+        }
+
+        // Writes 1.0f for the ball and the paddle and 0.0f elsewhere, the same as filling from PongGame::screen != 0
+        void render(const std::size_t& game, float* values, const std::size_t& width, const std::size_t& height) const {
+            std::fill(values, values + width * height, 0.0f);
+
+            draw(values, width, height, ball_x[game], ball_y[game], BALL_SIZE, BALL_SIZE);
+            draw(values, width, height, paddle_x[game], PADDLE_Y, PADDLE_WIDTH, PADDLE_HEIGHT);
+        }
+
+        void render(const std::size_t& game, m964::Layer& state) const {
+            render(game, state.data(), state.get_width(), state.get_height());
+        }
+};
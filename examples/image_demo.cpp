@@ -20,18 +20,23 @@ auto model_demonstrate(Model& model, const size_t& N_evolution_steps, int img_wi
     std::cout << "Demonstrating model (" << img_width << "x" << img_height << ") for "
               << N_evolution_steps << " steps. File prefix: " << file_prefix << std::endl;
 
+    // Every step goes into one compressed trajectory, decode single steps with trajectory_dump
+    const auto trajectory_file = "result/" + file_prefix + "trajectory.m964traj";
+    auto recorder = TrajectoryRecorder(trajectory_file, model.width, model.height);
+    auto exporter = FrameExporter({ .format = FrameFormat::PNG });
+
     for (std::int32_t t = 0; t < N_evolution_steps; ++t) {
         model.simulate_step_with_biases();
-        // Assuming export_state_as_image can handle model.get_new_state()
-        // It would be ideal if Model knew its own dimensions or if export_state_as_image took them.
-        export_state_as_image("result/" + file_prefix + "state_step_" + std::to_string(t) + ".png", model.get_new_state());
+        recorder.record(model.get_new_state());
         if (t % 10 == 0 || t == N_evolution_steps -1 ) { // Print progress less often
-            std::cout << "  Exported " << file_prefix << "state_step_" << std::to_string(t) << ".png" << std::endl;
+            std::cout << "  Recorded step " << std::to_string(t) << " to " << trajectory_file << std::endl;
         }
         std::this_thread::sleep_for(std::chrono::milliseconds(100)); // Adjusted for potentially better viewing
     }
 
-    export_state_as_image("result/" + file_prefix + "result_final.png", model.get_new_state());
+    recorder.close();
+    exporter.submit("result/" + file_prefix + "result_final.png", model.get_new_state());
+    exporter.flush();
     std::cout << "Exported final demonstration result: " << file_prefix << "result_final.png" << std::endl;
 }
 
@@ -39,16 +44,16 @@ auto main() -> std::int32_t {
     try {
         const std::string target_image_filename = "test_image_2.png";
 
-        auto target_image = load_image(target_image_filename);
-        if (!target_image.isValid()) {
+        auto target_image = load_image_target(target_image_filename);
+        if (!target_image || !target_image->is_valid()) {
             std::cerr << "Critical Error: Failed to load or process target image. Exiting." << std::endl;
             return 1;
         }
-        std::cout << "Target image '" << target_image_filename << "' loaded: " << target_image.width << "x" << target_image.height << std::endl;
+        std::cout << "Target image '" << target_image_filename << "' loaded: " << target_image->width << "x" << target_image->height << std::endl;
 
-        const auto& target_pixel_data = target_image.data;
-        const int img_width = target_image.width;
-        const int img_height = target_image.height;
+        const auto& target_layer = target_image->channels[0];
+        const int img_width = static_cast<int>(target_image->width);
+        const int img_height = static_cast<int>(target_image->height);
 
         auto parameters = GeneticAlgorithmTrainingParameters {
             .model_width = static_cast<size_t>(img_width),
@@ -61,7 +66,10 @@ auto main() -> std::int32_t {
             .print_interval_epochs = 20
         };
 
-        auto model_cost_function = [&](Model &model) {
+        // Per-epoch phase timings, one JSON object per line
+        parameters.telemetry_sink = std::make_shared<JsonLinesTelemetrySink>("result/telemetry.jsonl");
+
+        auto model_cost_function = [&](Model &model, const float& cutoff) -> std::optional<float> {
             model.reset_states();
 
             model.get_old_state().fill([]() {
@@ -71,19 +79,11 @@ auto main() -> std::int32_t {
             auto accumulated_cost_over_steps = 0.0f;
 
             for (std::int32_t current_step = 0; current_step < parameters.n_evolution_steps; ++current_step) {
-                model.simulate_step_with_biases();
-                const auto& current_model_state = model.get_new_state();
-                float cost_for_this_step = 0.0f;
-
-                for (int i = 0; i < img_width; ++i) {
-                    for (int j = 0; j < img_height; ++j) {
-                        const float target_value = target_pixel_data[i][j];
-                        const float model_output_value = current_model_state(i, j);
-                        const float difference = model_output_value - target_value;
-                        cost_for_this_step += difference * difference;
-                    }
-                }
+                const float cost_for_this_step = simulate_step_with_loss(model, target_layer, LossKind::SquaredError, LossReduction::Sum);
                 accumulated_cost_over_steps += cost_for_this_step;
+
+                if (accumulated_cost_over_steps / static_cast<float>(parameters.n_evolution_steps) >= cutoff)
+                    return std::nullopt;
             }
 
             if (parameters.n_evolution_steps == 0) return 0.0f;
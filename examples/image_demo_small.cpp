@@ -17,7 +17,9 @@ auto model_demonstrate(Model& model, const size_t& N_evolution_steps, std::strin
     auto img_width = target_image.width;
     auto img_height = target_image.height;
 
-    auto buffer = std::vector<std::int32_t> {};
+    const auto color_map = ColorMap();
+
+    auto buffer = std::vector<std::uint32_t> {};
     buffer.resize(img_width * img_height);
 
     for(size_t x = 0; x < img_width; ++x) {
@@ -32,7 +34,7 @@ auto model_demonstrate(Model& model, const size_t& N_evolution_steps, std::strin
 
             auto value = model.get_new_state()(3, 3);
 
-            buffer[x + y*img_width] = hsl_to_rgb((1 - value) * 255, 0.5f, 1.0f);
+            buffer[x + y*img_width] = color_map(value);
         }
     }
 
@@ -55,16 +57,16 @@ auto main() -> std::int32_t {
             .print_interval_epochs = 20
         };
 
-        auto target_image = load_image(target_image_filename);
-        if (!target_image.isValid()) {
+        auto target_image = load_image_target(target_image_filename);
+        if (!target_image || !target_image->is_valid()) {
             std::cerr << "Critical Error: Failed to load or process target image. Exiting." << std::endl;
             return 1;
         }
-        std::cout << "Target image '" << target_image_filename << "' loaded: " << target_image.width << "x" << target_image.height << std::endl;
+        std::cout << "Target image '" << target_image_filename << "' loaded: " << target_image->width << "x" << target_image->height << std::endl;
 
-        const auto& target_pixel_data = target_image.data;
-        const int img_width = target_image.width;
-        const int img_height = target_image.height;
+        const auto& target_pixel_data = target_image->channels[0];
+        const int img_width = static_cast<int>(target_image->width);
+        const int img_height = static_cast<int>(target_image->height);
 
         auto model_cost_function = [&](Model &model) {
             auto accumulated_cost_over_steps = 0.0f;
@@ -78,7 +80,7 @@ auto main() -> std::int32_t {
                         model.get_old_state()(0, 3) = static_cast<float>(j) / static_cast<float>(img_height);
                         model.simulate_step_with_biases();
                         const auto& current_model_state = model.get_new_state(); // Assuming this provides access to cell states
-                        const float difference = current_model_state(3, 3) - target_pixel_data[i][j];
+                        const float difference = current_model_state(3, 3) - target_pixel_data(i, j);
                         accumulated_cost_over_steps += difference * difference;
                     }
                 }
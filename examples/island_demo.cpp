@@ -0,0 +1,75 @@
+#include <iostream>
+#include <string>
+#include <cstdlib>
+
+#include "96m4.h"
+#include "utils.hpp"
+
+using namespace m964;
+
+// Start one process per island, e.g. `island_demo 0 4 & island_demo 1 4 & island_demo 2 4 & island_demo 3 4`
+auto main(const int argc, char* argv[]) -> std::int32_t {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <island id> <island count> [migration interval] [threads per island]" << std::endl;
+        return 1;
+    }
+
+    auto island_parameters = IslandParameters {
+        .island_id = static_cast<std::size_t>(std::atoi(argv[1])),
+        .island_count = static_cast<std::size_t>(std::atoi(argv[2])),
+        .migration_interval_epochs = argc > 3 ? std::atoi(argv[3]) : 50,
+        .topology = MigrationTopology::Ring,
+        .socket_directory = "/tmp"
+    };
+
+    auto parameters = GeneticAlgorithmTrainingParameters {
+        .model_width = 4,
+        .model_height = 4,
+        .n_evolution_steps = 16,
+        .population_size = 100,
+        .initial_mutation_strength = 0.1f,
+        .target_cost_threshold = 0.05f,
+        .max_epochs = 100000,
+        .print_interval_epochs = 100
+    };
+
+    parameters.thread_count = argc > 4 ? static_cast<std::size_t>(std::atoi(argv[4])) : 0;
+
+    const auto x_start = -0.8f;
+    const auto x_end = 0.3f;
+    const auto step = 0.025f;
+
+    auto studied_function = [](const float& x) {
+        return 2*x*x + x + 0.25f;
+    };
+
+    auto model_cost_function = [&](Model &model) {
+        auto accumulated_cost_over_steps = 0.0f;
+
+        auto point = x_start;
+        while (point < x_end) {
+            model.reset_states();
+
+            for (std::size_t current_step = 0; current_step < parameters.n_evolution_steps; ++current_step) {
+                model.get_old_state()(0, 0) = point;
+                model.simulate_step_with_biases();
+            }
+
+            const float difference = model.get_new_state()(3, 3) - studied_function(point);
+            accumulated_cost_over_steps += difference * difference;
+
+            point += step;
+        }
+
+        return accumulated_cost_over_steps;
+    };
+
+    try {
+        auto best_model = genetic_algorithm_training_island(model_cost_function, parameters, island_parameters);
+        std::cout << "Island " << island_parameters.island_id << " final cost: " << model_cost_function(best_model) << std::endl;
+    } catch (const std::exception &e) {
+        std::cout << e.what() << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,56 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include <chrono>
+
+#include "96m4.h"
+
+using namespace m964;
+
+// Watches a running demo, e.g. `live_viewer state` renders the model state of pong_demo to the terminal,
+// `live_viewer game game.png` keeps game.png up to date from this process instead of the simulation.
+auto main(const int argc, char* argv[]) -> std::int32_t {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <feed name> [output png]" << std::endl;
+        return 1;
+    }
+
+    const auto feed = LiveFeedReader(argv[1]);
+    if (!feed.is_open())
+        return 1;
+
+    const auto output = argc > 2 ? std::string(argv[2]) : std::string();
+    auto exporter = FrameExporter({ .format = FrameFormat::PNG });
+
+    auto state = Layer(feed.get_width(), feed.get_height());
+    auto last_frame = std::uint64_t{0};
+    auto has_frame = false;
+
+    while (true) {
+        auto frame = std::uint64_t{0};
+
+        if (feed.read_latest(state, frame) && (!has_frame || frame != last_frame)) {
+            if (!output.empty()) {
+                exporter.submit(output, state);
+            } else {
+                std::cout << "\033[H\033[2J" << argv[1] << " frame " << frame << "\n";
+
+                for (std::size_t y = 0; y < state.get_height(); ++y) {
+                    for (std::size_t x = 0; x < state.get_width(); ++x) {
+                        const auto value = state(x, y);
+                        std::cout << (value > 0.75f ? '#' : value > 0.5f ? '+' : value > 0.25f ? '.' : ' ');
+                    }
+
+                    std::cout << "\n";
+                }
+
+                std::cout << std::flush;
+            }
+
+            last_frame = frame;
+            has_frame = true;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+}
@@ -22,7 +22,7 @@ auto model_demonstrate(float x_start, float x_end, float step, int n_evolution_s
             model.simulate_step_with_biases();
         }
 
-        const auto& current_model_state = model.get_new_state();
+        const auto& current_model_state = model.get_old_state();
         std::cout << "(" << point << ", " << current_model_state(3, 3) << ")\n";
 
         point += step;
@@ -56,31 +56,23 @@ auto sample(float x_start, float x_end, float step, const std::function<float(fl
             .print_interval_epochs = 20
         };
 
-        auto model_cost_function = [&](Model &model) {
-            auto accumulated_cost_over_steps = 0.0f;
+        // One sample per point: the point is held at (0, 0) and (3, 3) is read one step before the end of the rollout,
+        // so the spec stops after n_evolution_steps - 1 steps and scores the state after its last step
+        auto spec = EvaluationSpec { .n_evolution_steps = parameters.n_evolution_steps - 1 };
 
-            auto point = x_start;
-            while (point < x_end) {
-                model.reset_states();
+        auto point = x_start;
+        while (point < x_end) {
+            spec.samples.push_back(EvaluationSample {
+                .injections = { Injection { 0, 0, point } },
+                .probes = { ProbeCell { 3, 3, studied_function(point) } }
+            });
 
-                for (std::int32_t current_step = 0; current_step < parameters.n_evolution_steps; ++current_step) {
-                    model.get_old_state()(0, 0) = point;
-                    model.simulate_step_with_biases();
-                }
-
-                const auto& current_model_state = model.get_new_state();
-                const float difference = current_model_state(3, 3) - studied_function(point);
-                accumulated_cost_over_steps += difference * difference;
-
-                point += step;
-            }
-
-            return accumulated_cost_over_steps;
-        };
+            point += step;
+        }
 
-        auto best_model = genetic_algorithm_training_hyper(model_cost_function, parameters);
+        auto best_model = genetic_algorithm_training_hyper(spec, parameters);
 
-        model_demonstrate(x_start, x_end, step, parameters.n_evolution_steps, studied_function, best_model);
+        model_demonstrate(x_start, x_end, step, parameters.n_evolution_steps - 1, studied_function, best_model);
     } catch (const std::exception &e) {
         std::cout << e.what() << std::endl;
     }
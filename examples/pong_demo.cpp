@@ -9,38 +9,58 @@
 #include "96m4.h"
 #include "utils.hpp"
 
-#include "games/pong.hpp"
+#include "games/pong_batch.hpp"
 
 using namespace m964;
 
 auto model_demonstrate(Model& model, const size_t& steps) -> void {
-    auto game = PongGame();
+    auto game = PongBatch(1);
     auto score = 0;
 
-    while (!game.is_game_over()) {
+    // Watch with `live_viewer state` and `live_viewer game`
+    auto state_feed = LiveFeedPublisher("state", model.width, model.height);
+    auto game_feed = LiveFeedPublisher("game", model.width, model.height);
+
+    while (!game.is_game_over(0)) {
         game.simulate_frame();
+        game.render(0, model.get_old_state());
 
-        model.get_old_state().fill([&](const auto &x, const auto &y) {
-            return game.screen[y][x] ? 1.0f : 0.0f;
-        });
+        game_feed.publish(model.get_old_state());
 
         for (std::int32_t t = 0; t < steps; ++t)
             model.simulate_step_with_biases();
 
         const auto sample = model.get_new_state()(16, 8);
-        if (sample < 0.5f) game.paddle_left();
-        if (sample > 0.5f) game.paddle_right();
+        game.move_paddles(&sample);
 
         ++score;
 
-        game.display_buffer();
-        export_state_as_image("state.png", model.get_new_state());
+        state_feed.publish(model.get_new_state());
         std::this_thread::sleep_for(std::chrono::milliseconds(50));
     }
 
     std::cout << score << std::endl;
 }
 
+// The paddle follows paddle_prediction(), not the model, so every candidate sees the same frames: record them once
+auto record_episode(const std::size_t& max_frames) -> ObservationTrajectory {
+    auto trajectory = ObservationTrajectory(PongBatch::SCREEN_WIDTH, PongBatch::SCREEN_HEIGHT);
+    auto game = PongBatch(1);
+    auto frame = Layer(PongBatch::SCREEN_WIDTH, PongBatch::SCREEN_HEIGHT);
+
+    for (std::size_t i = 0; i < max_frames && !game.is_game_over(0); ++i) {
+        game.simulate_frame();
+        game.render(0, frame);
+
+        const auto expected = game.paddle_prediction(0);
+        trajectory.record(frame, { &expected, 1 });
+
+        game.move_paddles(&expected);
+    }
+
+    return trajectory;
+}
+
 [[noreturn]] auto main() -> std::int32_t {
     try {
         auto parameters = GeneticAlgorithmTrainingParameters {
@@ -51,41 +71,19 @@ auto model_demonstrate(Model& model, const size_t& steps) -> void {
             .initial_mutation_strength = 1.0f,
             .target_cost_threshold = 10.0f,
             .max_epochs = 100000,
-            .print_interval_epochs = 20
+            .print_interval_epochs = 20,
+            .print_interval_evaluations = 200
         };
 
-        auto model_cost_function = [&](Model &model) {
-            auto game = PongGame();
-            auto score = 0;
-            auto cost = 0.0f;
-
-            while (!game.is_game_over()) {
-                game.simulate_frame();
-
-                model.get_old_state().fill([&](const auto &x, const auto &y) {
-                    return game.screen[y][x] ? 1.0f : 0.0f;
-                });
-
-                for (std::int32_t t = 0; t < parameters.n_evolution_steps; ++t)
-                    model.simulate_step_with_biases();
-
-                const auto sample = model.get_new_state()(16, 8);
-                const auto expected = game.paddle_prediction();
-                cost += std::fabs(expected - sample);
+        const auto episode = record_episode(501);
 
-                if (expected < 0.5f) game.paddle_left();
-                if (expected > 0.5f) game.paddle_right();
-
-                ++score;
-
-                if (score > 500)
-                    break;
-            }
-
-            return cost;
+        auto model_cost_function = [&](Model &model) {
+            return replay_trajectory(model, episode, parameters.n_evolution_steps, [](const Layer& state, std::span<const float> targets) {
+                return std::fabs(targets[0] - state(16, 8));
+            });
         };
 
-        auto best_model = genetic_algorithm_training_hyper(model_cost_function, parameters);
+        auto best_model = genetic_algorithm_training_steady_state(model_cost_function, parameters);
 
         while (1)
             model_demonstrate(best_model, parameters.n_evolution_steps);
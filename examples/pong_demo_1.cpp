@@ -6,64 +6,114 @@
 #include <execution>
 #include <mutex>
 #include <unordered_set>
+#include <span>
+#include <optional>
 
 #include "96m4.h"
 #include "utils.hpp"
 
 #include "games/pong.hpp"
+#include "games/pong_batch.hpp"
 
 using namespace m964;
 
-auto model_cost(Model &model, const size_t& steps) -> float {
-    auto game = PongGame();
-    auto score = 0;
-    auto cost = 0.0f;
+// --streaming: the state carries over between frames and every frame blends the screen in and runs 4 steps,
+// instead of resetting the state and running steps +/- 3 steps per frame
+auto streaming_parameters(const size_t& steps) -> StreamingParameters {
+    return StreamingParameters {
+        .steps_per_frame = 4,
+        .warmup_steps = steps,
+        .policy = InjectionPolicy::Blend,
+        .blend_factor = 0.5f,
+        .biases = false
+    };
+}
 
-    while (!game.is_game_over()) {
-        game.simulate_frame();
+// Plays one game per model, all games of the batch in lockstep
+auto model_costs(std::span<Model> models, const size_t& steps, const std::optional<StreamingParameters>& streaming) -> std::vector<float> {
+    auto games = PongBatch(models.size());
+    auto costs = std::vector<float>(models.size(), 0.0f);
+    auto actions = std::vector<float>(models.size(), 0.5f);
+    auto running = std::vector<std::size_t>{};
 
-        model.reset_states();
-        model.get_old_state().fill([&](const auto &x, const auto &y) {
-            return game.screen[y][x] ? 1.0f : 0.0f;
-        });
+    auto controllers = std::vector<StreamingController>{};
+    auto frame = Layer(PongBatch::SCREEN_WIDTH, PongBatch::SCREEN_HEIGHT);
+
+    if (streaming) {
+        for (auto& model : models) {
+            controllers.emplace_back(*streaming);
+            controllers.back().reset(model);
+        }
+    }
 
-        auto offset = rand_int(-3, 3);
-        for (std::int32_t t = 0; t < (steps + offset); ++t)
-            model.simulate_step();
+    for (auto score = 0; score <= 1000; ++score) {
+        running.clear();
+        for (std::size_t i = 0; i < models.size(); ++i)
+            if (!games.is_game_over(i))
+                running.push_back(i);
 
-        const auto sample = model.get_new_state()(16, 8);
-        const auto expected = game.paddle_prediction();
-        cost += 1 - std::fabs(expected - sample);
+        if (running.empty())
+            break;
 
-        if (sample < 0.5f) game.paddle_left();
-        if (sample > 0.5f) game.paddle_right();
+        games.simulate_frame();
 
-        ++score;
+        for (const auto i : running) {
+            auto& model = models[i];
+            auto sample = 0.0f;
 
-        if (score > 1000)
-            break;
+            if (streaming) {
+                games.render(i, frame);
+                sample = controllers[i].step(model, frame)(16, 8);
+            } else {
+                model.reset_states();
+                games.render(i, model.get_old_state());
+
+                // get_new_state() after steps + offset steps, only the light cone of the read cell is computed
+                auto offset = rand_int(-3, 3);
+                simulate_steps_for_readout(model, CellRegion { 16, 17, 8, 9 }, static_cast<std::size_t>(steps + offset - 1), false);
+
+                sample = model.get_old_state()(16, 8);
+            }
+
+            const auto expected = games.paddle_prediction(i);
+            costs[i] += 1 - std::fabs(expected - sample);
+
+            actions[i] = sample;
+        }
+
+        games.move_paddles(actions.data());
     }
 
-    return cost;
+    return costs;
 }
 
-auto model_demonstrate(Model& model, const size_t& steps) -> void {
+auto model_demonstrate(Model& model, const size_t& steps, const std::optional<StreamingParameters>& streaming) -> void {
     auto game = PongGame();
     auto score = 0;
 
+    auto controller = StreamingController(streaming.value_or(StreamingParameters{}));
+    auto frame = Layer(32, 16);
+    controller.reset(model);
+
     while (!game.is_game_over()) {
         game.simulate_frame();
 
-        model.reset_states();
-        model.get_old_state().fill([&](const auto &x, const auto &y) {
-            return game.screen[y][x] ? 1.0f : 0.0f;
-        });
+        auto sample = 0.0f;
+
+        if (streaming) {
+            load_bitmap(frame, game.screen);
+            sample = controller.step(model, frame)(16, 8);
+        } else {
+            model.reset_states();
+            load_bitmap(model.get_old_state(), game.screen);
 
-        auto offset = rand_int(-3, 3);
-        for (std::int32_t t = 0; t < (steps + offset); ++t)
-            model.simulate_step();
+            auto offset = rand_int(-3, 3);
+            for (std::int32_t t = 0; t < (steps + offset); ++t)
+                model.simulate_step();
+
+            sample = model.get_new_state()(16, 8);
+        }
 
-        const auto sample = model.get_new_state()(16, 8);
         if (sample < 0.5f) game.paddle_left();
         if (sample > 0.5f) game.paddle_right();
 
@@ -77,13 +127,20 @@ auto model_demonstrate(Model& model, const size_t& steps) -> void {
     std::cout << score << std::endl;
 }
 
-[[noreturn]] auto main() -> std::int32_t {
+[[noreturn]] auto main(const int argc, char* argv[]) -> std::int32_t {
+    auto arguments = std::unordered_set<std::string> {};
+
+    for (int i = 1; i < argc; ++i)
+        arguments.insert(argv[i]);
+
     auto steps = 24;
 
+    const auto streaming = arguments.contains("--streaming") ? std::optional<StreamingParameters>(streaming_parameters(steps)) : std::nullopt;
+
     auto best_mutex = std::mutex {};
     auto best = Model(32u, 16u);
     auto found_best = false;
-    auto best_cost = model_cost(best, steps);
+    auto best_cost = model_costs(std::span<Model>(&best, 1), steps, streaming)[0];
 
     best.weights.fill([]() {
         return Kernel().fill(m964::rand_float(-1.0, 1.0f));
@@ -108,15 +165,24 @@ auto model_demonstrate(Model& model, const size_t& steps) -> void {
             models.push_back(model);
         }
 
+        // One batch of games per thread
         auto executor = ParallelExecutor();
-        executor.execute(models.begin(), models.end(), [&](auto &model) {
-            auto cost = model_cost(model, steps);
+        const auto batch_count = std::min<std::size_t>(models.size(), std::max(1u, std::thread::hardware_concurrency()));
+
+        auto batches = std::vector<std::span<Model>>{};
+        for (std::size_t b = 0; b < batch_count; ++b)
+            batches.emplace_back(models.data() + models.size() * b / batch_count, models.data() + models.size() * (b + 1) / batch_count);
+
+        executor.execute(batches.begin(), batches.end(), [&](auto &batch) {
+            const auto costs = model_costs(batch, steps, streaming);
 
             best_mutex.lock();
-            if (cost > best_cost) {
-                best_cost = cost;
-                best = model;
-                found_best = true;
+            for (std::size_t i = 0; i < batch.size(); ++i) {
+                if (costs[i] > best_cost) {
+                    best_cost = costs[i];
+                    best = batch[i];
+                    found_best = true;
+                }
             }
             best_mutex.unlock();
         });
@@ -136,7 +202,7 @@ auto model_demonstrate(Model& model, const size_t& steps) -> void {
     std::cout << "Training is finished !\n";
 
     while(1)
-        model_demonstrate(best, 24);
+        model_demonstrate(best, 24, streaming);
 
     return 0;
 }
@@ -55,7 +55,10 @@ auto model_demonstrate(Model& model, const size_t& steps) -> void {
             .print_interval_epochs = 20
         };
 
-        auto model_cost_function = [&](Model &model) {
+        // Fidelity is the fraction of the frame budget to play, most mutants are already out after the first eighth
+        auto model_cost_function = [&](Model &model, const float& fidelity) {
+            const auto max_frames = static_cast<int>(fidelity * 1000.0f);
+
             auto game = PongGame();
             auto score = 0;
             auto cost = 0.0f;
@@ -82,14 +85,14 @@ auto model_demonstrate(Model& model, const size_t& steps) -> void {
 
                 ++score;
 
-                if (score > 1000)
+                if (score > max_frames)
                     break;
             }
 
             return cost / static_cast<float>(parameters.n_evolution_steps);
         };
 
-        auto best_model = genetic_algorithm_training_hyper(model_cost_function, parameters);
+        auto best_model = genetic_algorithm_training_successive_halving(model_cost_function, parameters);
 
         while (1)
             model_demonstrate(best_model, parameters.n_evolution_steps);
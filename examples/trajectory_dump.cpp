@@ -0,0 +1,41 @@
+#include <iostream>
+#include <string>
+#include <cstdlib>
+
+#include "96m4.h"
+
+using namespace m964;
+
+// Decodes single steps of a recorded trajectory, e.g. `trajectory_dump result/final_best_trajectory.m964traj 0 10 20`
+auto main(const int argc, char* argv[]) -> std::int32_t {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <trajectory file> [step ...]" << std::endl;
+        return 1;
+    }
+
+    auto reader = TrajectoryReader(argv[1]);
+    if (!reader.is_open())
+        return 1;
+
+    std::cout << "Trajectory " << argv[1] << ": " << reader.get_width() << "x" << reader.get_height()
+              << ", " << reader.frame_count() << " steps" << std::endl;
+
+    auto state = Layer(reader.get_width(), reader.get_height());
+    auto exporter = FrameExporter({ .drop_policy = FrameDropPolicy::Block, .format = FrameFormat::PNG });
+
+    for (int i = 2; i < argc; ++i) {
+        const auto step = static_cast<std::size_t>(std::atoll(argv[i]));
+
+        if (!reader.read(step, state)) {
+            std::cerr << "Step " << step << " is not in the trajectory." << std::endl;
+            continue;
+        }
+
+        const auto file_name = "trajectory_step_" + std::to_string(step) + ".png";
+        exporter.submit(file_name, state);
+        std::cout << "Exported " << file_name << std::endl;
+    }
+
+    exporter.flush();
+    return 0;
+}
@@ -6,61 +6,16 @@
 #include "stb_image_write.h"
 #include "stb_image.h"
 
-float hue_to_rgb(float v1, float v2, float vH) {
-	if (vH < 0)
-		vH += 1;
-
-	if (vH > 1)
-		vH -= 1;
-
-	if ((6 * vH) < 1)
-		return (v1 + (v2 - v1) * 6 * vH);
-
-	if ((2 * vH) < 1)
-		return v2;
-
-	if ((3 * vH) < 2)
-		return (v1 + (v2 - v1) * ((2.0f / 3) - vH) * 6);
-
-	return v1;
-}
-
-std::uint32_t hsl_to_rgb(float H, float L, float S) {
-    std::uint32_t rgb;
-
-	if (S == 0) {
-        const auto v = (std::uint8_t)(L * 255);
-        rgb = (255 << 24) | (v << 16) | (v << 8) | (v);
-	} else {
-		float v1, v2;
-		float hue = (float)H / 360;
-
-		v2 = (L < 0.5) ? (L * (1 + S)) : ((L + S) - (L * S));
-		v1 = 2 * L - v2;
-
-		auto r = (std::uint8_t)(255 * hue_to_rgb(v1, v2, hue + (1.0f / 3)));
-		auto g = (std::uint8_t)(255 * hue_to_rgb(v1, v2, hue));
-		auto b = (std::uint8_t)(255 * hue_to_rgb(v1, v2, hue - (1.0f / 3)));
-
-        rgb = (255 << 24) | (b << 16) | (g << 8) | (r);
-	}
-
-	return rgb;
-}
-
 auto export_state_as_image(const std::string& file_name, const m964::Layer& state) -> void {
+    static const auto color_map = m964::ColorMap();
+
     const auto width = state.get_width();
     const auto height = state.get_height();
 
-	auto buffer = std::vector<std::int32_t> {};
+	auto buffer = std::vector<std::uint32_t> {};
     buffer.resize(width * height);
 
-    for(size_t x = 0; x < width; ++x) {
-        for(size_t y = 0; y < height; ++y) {
-            auto value = state(x, y);
-            buffer[x + y*width] = hsl_to_rgb((1 - value) * 255, 0.5f, 1.0f);
-        }
-    }
+    color_map.map(state.data(), buffer.data(), buffer.size());
 
     stbi_write_jpg(file_name.c_str(), width, height, 4, buffer.data(), width * sizeof(std::int32_t));
 }
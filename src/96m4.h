@@ -6,3 +6,22 @@
 #include "utils.h"
 #include "parallel_executor.h"
 #include "training.h"
+#include "checkpoint.h"
+#include "island.h"
+#include "loss.h"
+#include "dataset.h"
+#include "frame_export.h"
+#include "trajectory.h"
+#include "live_feed.h"
+#include "telemetry.h"
+#include "perf_counters.h"
+#include "kernels.h"
+#include "observation.h"
+#include "streaming.h"
+#include "model_batch.h"
+#include "episode.h"
+#include "evaluation.h"
+#include "light_cone.h"
+#include "incremental.h"
+#include "parameter_blocks.h"
+#include "scratch.h"
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace m964 {
+    // Cache line aligned storage, so whole-buffer loops start on a vector boundary
+    constexpr std::size_t PARAMETER_ALIGNMENT = 64;
+
+    template<typename T, std::size_t Alignment = PARAMETER_ALIGNMENT>
+    struct AlignedAllocator {
+        using value_type = T;
+
+        template<typename U>
+        struct rebind {
+            using other = AlignedAllocator<U, Alignment>;
+        };
+
+        AlignedAllocator() noexcept = default;
+
+        template<typename U>
+        AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+        auto allocate(const std::size_t count) -> T* {
+            return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t{ Alignment }));
+        }
+
+        auto deallocate(T* pointer, const std::size_t) noexcept -> void {
+            ::operator delete(pointer, std::align_val_t{ Alignment });
+        }
+
+        template<typename U>
+        auto operator==(const AlignedAllocator<U, Alignment>&) const noexcept -> bool {
+            return true;
+        }
+    };
+}
@@ -0,0 +1,407 @@
+#include "checkpoint.h"
+#include "trajectory.h"
+
+#include <cstring>
+#include <sstream>
+#include <filesystem>
+
+namespace m964 {
+    namespace {
+        template<typename T>
+        auto write_value(std::ostream& stream, const T& value) -> void {
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        template<typename T>
+        auto read_value(std::istream& stream, T& value) -> bool {
+            stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+            return static_cast<bool>(stream);
+        }
+
+        auto has_magic(std::istream& stream, const char (&magic)[8]) -> bool {
+            char buffer[8];
+            stream.read(buffer, sizeof(buffer));
+            return stream && std::memcmp(buffer, magic, sizeof(buffer)) == 0;
+        }
+
+        auto parameter_count(const std::size_t& width, const std::size_t& height) -> std::size_t {
+            return width * height * PARAMETERS_PER_CELL;
+        }
+
+        auto read_parameter_bits(const Model& model) -> std::vector<std::uint32_t> {
+            const auto values = model.parameters();
+            auto bits = std::vector<std::uint32_t>(values.size());
+
+            std::memcpy(bits.data(), values.data(), values.size_bytes());
+
+            return bits;
+        }
+
+        auto write_parameter_bits(Model& model, const std::vector<std::uint32_t>& bits) -> void {
+            const auto values = model.parameters();
+
+            std::memcpy(values.data(), bits.data(), values.size_bytes());
+        }
+
+        enum LineageRecordKind : std::uint8_t {
+            LINEAGE_KEYFRAME = 0,
+            LINEAGE_PACKED_DELTA = 2 // XOR words, byte-plane shuffled and LZ compressed
+        };
+    }
+
+    auto capture_random_state() -> std::string {
+        std::ostringstream oss;
+        oss << random_engine();
+        return oss.str();
+    }
+
+    auto restore_random_state(const std::string& state) -> bool {
+        std::istringstream iss(state);
+        auto engine = std::mt19937{};
+
+        if (!(iss >> engine))
+            return false;
+
+        random_engine() = engine;
+        return true;
+    }
+
+    auto save_checkpoint(const std::string& file_name, const TrainingCheckpoint& checkpoint) -> bool {
+        const auto temporary_file_name = file_name + ".tmp";
+
+        {
+            std::ofstream stream(temporary_file_name, std::ios::binary | std::ios::trunc);
+            if (!stream) {
+                std::cerr << "Error [save_checkpoint]: Could not open " << temporary_file_name << " for writing." << std::endl;
+                return false;
+            }
+
+            stream.write(CHECKPOINT_FILE_MAGIC, sizeof(CHECKPOINT_FILE_MAGIC));
+            write_value<std::int64_t>(stream, checkpoint.epoch_count);
+            write_value<std::int64_t>(stream, checkpoint.generation_count);
+            write_value(stream, checkpoint.best_cost);
+            write_value(stream, checkpoint.prev_cost);
+            write_value(stream, checkpoint.epoch_avg_time);
+            write_value(stream, checkpoint.mutation_strength);
+            write_value<std::uint64_t>(stream, checkpoint.random_state.size());
+            stream.write(checkpoint.random_state.data(), static_cast<std::streamsize>(checkpoint.random_state.size()));
+            checkpoint.best_model.save(stream);
+
+            if (!stream.flush()) {
+                std::cerr << "Error [save_checkpoint]: Failed writing " << temporary_file_name << "." << std::endl;
+                return false;
+            }
+        }
+
+        auto error = std::error_code{};
+        std::filesystem::rename(temporary_file_name, file_name, error);
+
+        if (error) {
+            std::cerr << "Error [save_checkpoint]: Could not replace " << file_name << ": " << error.message() << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    namespace {
+        // The serialized std::mt19937 is a few kilobytes, anything far beyond that is a corrupt size field
+        constexpr std::uint64_t MAX_RANDOM_STATE_SIZE = 1 << 20;
+
+        auto read_checkpoint(const std::string& file_name, const std::size_t* width, const std::size_t* height) -> std::optional<TrainingCheckpoint> {
+            std::ifstream stream(file_name, std::ios::binary);
+            if (!stream)
+                return std::nullopt;
+
+            if (!has_magic(stream, CHECKPOINT_FILE_MAGIC)) {
+                std::cerr << "Error [load_checkpoint]: " << file_name << " is not a training checkpoint." << std::endl;
+                return std::nullopt;
+            }
+
+            auto checkpoint = TrainingCheckpoint{};
+            std::int64_t epoch_count = 0;
+            std::int64_t generation_count = 0;
+            std::uint64_t random_state_size = 0;
+
+            auto valid = read_value(stream, epoch_count)
+                && read_value(stream, generation_count)
+                && read_value(stream, checkpoint.best_cost)
+                && read_value(stream, checkpoint.prev_cost)
+                && read_value(stream, checkpoint.epoch_avg_time)
+                && read_value(stream, checkpoint.mutation_strength)
+                && read_value(stream, random_state_size)
+                && random_state_size <= MAX_RANDOM_STATE_SIZE;
+
+            if (valid) {
+                checkpoint.random_state.resize(random_state_size);
+                stream.read(checkpoint.random_state.data(), static_cast<std::streamsize>(random_state_size));
+                valid = static_cast<bool>(stream);
+            }
+
+            auto model = std::optional<Model>{};
+            if (valid)
+                model = width && height ? Model::load(stream, *width, *height) : Model::load(stream);
+
+            if (!model) {
+                std::cerr << "Error [load_checkpoint]: " << file_name << " is truncated or corrupted or holds a model of other dimensions." << std::endl;
+                return std::nullopt;
+            }
+
+            checkpoint.epoch_count = epoch_count;
+            checkpoint.generation_count = generation_count;
+            checkpoint.best_model = std::move(*model);
+
+            return checkpoint;
+        }
+    }
+
+    auto load_checkpoint(const std::string& file_name) -> std::optional<TrainingCheckpoint> {
+        return read_checkpoint(file_name, nullptr, nullptr);
+    }
+
+    auto load_checkpoint(const std::string& file_name, const std::size_t& width, const std::size_t& height) -> std::optional<TrainingCheckpoint> {
+        return read_checkpoint(file_name, &width, &height);
+    }
+
+    ModelLineageLog::ModelLineageLog(
+        const std::string& file_name,
+        const std::size_t& width,
+        const std::size_t& height
+    ) : width(width),
+        height(height),
+        has_previous(false)
+    {
+        const auto exists = std::filesystem::exists(file_name) && std::filesystem::file_size(file_name) > 0;
+
+        if (exists) {
+            std::ifstream existing(file_name, std::ios::binary);
+            std::uint64_t dimensions[2] = { 0, 0 };
+
+            if (!has_magic(existing, LINEAGE_FILE_MAGIC) || !read_value(existing, dimensions) || dimensions[0] != width || dimensions[1] != height) {
+                std::cerr << "Warning [ModelLineageLog]: " << file_name << " belongs to a different model, lineage will not be recorded." << std::endl;
+                return;
+            }
+        }
+
+        stream.open(file_name, std::ios::binary | std::ios::app);
+
+        if (stream && !exists) {
+            const std::uint64_t dimensions[2] = { width, height };
+            stream.write(LINEAGE_FILE_MAGIC, sizeof(LINEAGE_FILE_MAGIC));
+            write_value(stream, dimensions);
+        }
+    }
+
+    auto ModelLineageLog::is_open() const -> bool {
+        return stream.is_open() && stream.good();
+    }
+
+    auto ModelLineageLog::append(const LineageRecord& record, const Model& model) -> void {
+        if (!is_open())
+            return;
+
+        const auto bits = read_parameter_bits(model);
+        auto payload = std::string(reinterpret_cast<const char*>(bits.data()), bits.size() * sizeof(std::uint32_t));
+        auto kind = LINEAGE_KEYFRAME;
+
+        // mutate_model touches every parameter, the XOR then only zeroes the sign and exponent bytes. A delta that
+        // does not come out smaller than the raw keyframe is written as a keyframe.
+        if (has_previous) {
+            auto words = std::vector<std::uint32_t>(bits.size());
+            for (std::size_t i = 0; i < bits.size(); ++i)
+                words[i] = bits[i] ^ previous[i];
+
+            auto planes = std::vector<std::uint8_t>(words.size() * sizeof(std::uint32_t));
+            auto compressed = std::vector<std::uint8_t>{};
+            shuffle_byte_planes(words.data(), words.size(), planes.data());
+            lz_compress(planes.data(), planes.size(), compressed);
+
+            if (compressed.size() < payload.size()) {
+                kind = LINEAGE_PACKED_DELTA;
+                payload.assign(reinterpret_cast<const char*>(compressed.data()), compressed.size());
+            }
+        }
+
+        write_value<std::int64_t>(stream, record.epoch);
+        write_value<std::int64_t>(stream, record.generation);
+        write_value(stream, record.cost);
+        write_value<std::uint8_t>(stream, kind);
+        write_value<std::uint64_t>(stream, payload.size());
+        stream.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+        stream.flush();
+
+        previous = bits;
+        has_previous = true;
+    }
+
+    auto replay_model_lineage(const std::string& file_name, const std::function<void(const LineageRecord&, const Model&)>& callback) -> bool {
+        std::ifstream stream(file_name, std::ios::binary);
+        std::uint64_t dimensions[2] = { 0, 0 };
+
+        if (!stream || !has_magic(stream, LINEAGE_FILE_MAGIC) || !read_value(stream, dimensions)) {
+            std::cerr << "Error [replay_model_lineage]: " << file_name << " is not a lineage log." << std::endl;
+            return false;
+        }
+
+        if (!Model::is_loadable_size(dimensions[0], dimensions[1])) {
+            std::cerr << "Error [replay_model_lineage]: " << file_name << " has invalid model dimensions " << dimensions[0] << "x" << dimensions[1] << "." << std::endl;
+            return false;
+        }
+
+        auto model = Model(dimensions[0], dimensions[1]);
+        auto bits = std::vector<std::uint32_t>(parameter_count(model.width, model.height));
+        auto has_keyframe = false;
+
+        while (stream.peek() != std::char_traits<char>::eof()) {
+            std::int64_t epoch = 0;
+            std::int64_t generation = 0;
+            std::uint64_t payload_size = 0;
+            std::uint8_t kind = 0;
+            auto record = LineageRecord{};
+
+            if (!read_value(stream, epoch) || !read_value(stream, generation) || !read_value(stream, record.cost) || !read_value(stream, kind) || !read_value(stream, payload_size)) {
+                std::cerr << "Warning [replay_model_lineage]: Truncated record at the end of " << file_name << "." << std::endl;
+                return true;
+            }
+
+            auto payload = std::string(payload_size, '\0');
+            stream.read(payload.data(), static_cast<std::streamsize>(payload_size));
+
+            if (!stream) {
+                std::cerr << "Warning [replay_model_lineage]: Truncated record at the end of " << file_name << "." << std::endl;
+                return true;
+            }
+
+            if (kind == LINEAGE_KEYFRAME) {
+                if (payload.size() != bits.size() * sizeof(std::uint32_t)) {
+                    std::cerr << "Error [replay_model_lineage]: Malformed keyframe in " << file_name << "." << std::endl;
+                    return false;
+                }
+
+                std::memcpy(bits.data(), payload.data(), payload.size());
+                has_keyframe = true;
+            } else if (kind == LINEAGE_PACKED_DELTA) {
+                auto planes = std::vector<std::uint8_t>(bits.size() * sizeof(std::uint32_t));
+                auto delta = std::vector<std::uint32_t>(bits.size());
+
+                if (!has_keyframe || !lz_decompress(reinterpret_cast<const std::uint8_t*>(payload.data()), payload.size(), planes.data(), planes.size())) {
+                    std::cerr << "Error [replay_model_lineage]: Malformed delta record in " << file_name << "." << std::endl;
+                    return false;
+                }
+
+                unshuffle_byte_planes(planes.data(), delta.size(), delta.data());
+
+                for (std::size_t i = 0; i < bits.size(); ++i)
+                    bits[i] ^= delta[i];
+            } else {
+                std::cerr << "Error [replay_model_lineage]: Malformed record in " << file_name << "." << std::endl;
+                return false;
+            }
+
+            record.epoch = epoch;
+            record.generation = generation;
+
+            write_parameter_bits(model, bits);
+            callback(record, model);
+        }
+
+        return true;
+    }
+
+    AsyncCheckpointWriter::AsyncCheckpointWriter(
+        const std::string& checkpoint_file_name,
+        const std::string& lineage_file_name,
+        const std::size_t& width,
+        const std::size_t& height
+    ) : checkpoint_file_name(checkpoint_file_name),
+        busy(false),
+        stopping(false)
+    {
+        if (!lineage_file_name.empty())
+            lineage_log.emplace(lineage_file_name, width, height);
+
+        worker = std::thread([this]() { run(); });
+    }
+
+    AsyncCheckpointWriter::~AsyncCheckpointWriter() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+
+        work_available.notify_one();
+
+        if (worker.joinable())
+            worker.join();
+    }
+
+    auto AsyncCheckpointWriter::submit_checkpoint(TrainingCheckpoint checkpoint) -> void {
+        if (checkpoint_file_name.empty())
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending_checkpoint = std::move(checkpoint);
+        }
+
+        work_available.notify_one();
+    }
+
+    auto AsyncCheckpointWriter::submit_lineage(const LineageRecord& record, Model model) -> void {
+        if (!lineage_log)
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending_lineage.emplace_back(record, std::move(model));
+        }
+
+        work_available.notify_one();
+    }
+
+    auto AsyncCheckpointWriter::flush() -> void {
+        std::unique_lock<std::mutex> lock(mutex);
+        work_done.wait(lock, [&]() {
+            return !busy && !pending_checkpoint && pending_lineage.empty();
+        });
+    }
+
+    auto AsyncCheckpointWriter::run() -> void {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        while (true) {
+            work_available.wait(lock, [&]() {
+                return stopping || pending_checkpoint || !pending_lineage.empty();
+            });
+
+            if (!pending_checkpoint && pending_lineage.empty())
+                break;
+
+            busy = true;
+
+            while (!pending_lineage.empty()) {
+                auto entry = std::move(pending_lineage.front());
+                pending_lineage.pop_front();
+
+                lock.unlock();
+                lineage_log->append(entry.first, entry.second);
+                lock.lock();
+            }
+
+            if (pending_checkpoint) {
+                auto checkpoint = std::move(*pending_checkpoint);
+                pending_checkpoint.reset();
+
+                lock.unlock();
+                save_checkpoint(checkpoint_file_name, checkpoint);
+                lock.lock();
+            }
+
+            busy = false;
+            work_done.notify_all();
+        }
+
+        busy = false;
+        work_done.notify_all();
+    }
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <fstream>
+#include <optional>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "model.h"
+
+namespace m964 {
+    constexpr char CHECKPOINT_FILE_MAGIC[8] = { 'M', '9', '6', '4', 'C', 'K', 'P', 'T' };
+    constexpr char LINEAGE_FILE_MAGIC[8] = { 'M', '9', '6', '4', 'L', 'I', 'N', 'E' };
+
+    struct TrainingCheckpoint {
+        Model best_model;
+        float best_cost = 0.0f;
+        float prev_cost = 0.0f;
+        long long generation_count = 1;
+        long long epoch_count = 0;
+        float epoch_avg_time = 0.0f;
+        float mutation_strength = 0.0f;
+        std::string random_state;
+    };
+
+    struct LineageRecord {
+        long long epoch = 0;
+        long long generation = 0;
+        float cost = 0.0f;
+    };
+
+    auto capture_random_state() -> std::string;
+    auto restore_random_state(const std::string& state) -> bool;
+
+    // Writes to a temporary file first and renames it over the target, so a crash never leaves a torn checkpoint
+    auto save_checkpoint(const std::string& file_name, const TrainingCheckpoint& checkpoint) -> bool;
+    auto load_checkpoint(const std::string& file_name) -> std::optional<TrainingCheckpoint>;
+    auto load_checkpoint(const std::string& file_name, const std::size_t& width, const std::size_t& height) -> std::optional<TrainingCheckpoint>; // rejects a best model of other dimensions
+
+    // Append-only history of best models. The first record after opening is a full keyframe, every following one
+    // stores the XOR of the parameter bits against the previous record, byte-plane shuffled and LZ compressed like
+    // trajectory frames. A delta that would not be smaller than the raw parameters is written as a keyframe instead.
+    class ModelLineageLog {
+        private:
+            std::ofstream stream;
+            std::size_t width;
+            std::size_t height;
+
+            std::vector<std::uint32_t> previous;
+            bool has_previous;
+
+        public:
+            ModelLineageLog(const std::string& file_name, const std::size_t& width, const std::size_t& height);
+
+            auto is_open() const -> bool;
+            auto append(const LineageRecord& record, const Model& model) -> void;
+    };
+
+    auto replay_model_lineage(const std::string& file_name, const std::function<void(const LineageRecord&, const Model&)>& callback) -> bool;
+
+    // Serializes checkpoints and lineage records on a background thread. Only the most recent
+    // pending checkpoint is kept, lineage records are written in submission order.
+    class AsyncCheckpointWriter {
+        private:
+            std::string checkpoint_file_name;
+            std::optional<ModelLineageLog> lineage_log;
+
+            std::optional<TrainingCheckpoint> pending_checkpoint;
+            std::deque<std::pair<LineageRecord, Model>> pending_lineage;
+            bool busy;
+            bool stopping;
+
+            std::mutex mutex;
+            std::condition_variable work_available;
+            std::condition_variable work_done;
+            std::thread worker;
+
+            auto run() -> void;
+
+        public:
+            AsyncCheckpointWriter(const std::string& checkpoint_file_name, const std::string& lineage_file_name, const std::size_t& width, const std::size_t& height);
+            ~AsyncCheckpointWriter();
+
+            AsyncCheckpointWriter(const AsyncCheckpointWriter&) = delete;
+            auto operator=(const AsyncCheckpointWriter&) -> AsyncCheckpointWriter& = delete;
+
+            auto submit_checkpoint(TrainingCheckpoint checkpoint) -> void;
+            auto submit_lineage(const LineageRecord& record, Model model) -> void;
+            auto flush() -> void;
+    };
+}
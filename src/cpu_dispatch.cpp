@@ -0,0 +1,85 @@
+#include "kernels.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <iostream>
+
+namespace m964 {
+    namespace {
+        auto is_supported(const CpuVariant& variant) -> bool {
+            switch (variant) {
+                case CpuVariant::Generic:
+                    return true;
+#if defined(M964_KERNEL_VARIANTS)
+                case CpuVariant::AVX2:
+                    return __builtin_cpu_supports("avx2");
+                case CpuVariant::AVX512:
+                    return __builtin_cpu_supports("avx512f");
+#else
+                default:
+                    return false;
+#endif
+            }
+
+            return false;
+        }
+
+        auto kernel_table(const CpuVariant& variant) -> KernelTable {
+            switch (variant) {
+#if defined(M964_KERNEL_VARIANTS)
+                case CpuVariant::AVX2:
+                    return avx2_kernels();
+                case CpuVariant::AVX512:
+                    return avx512_kernels();
+#endif
+                default:
+                    return generic_kernels();
+            }
+        }
+
+        auto select_kernels() -> KernelTable {
+            auto variant = supported_cpu_variant();
+
+            if (const auto* forced = std::getenv("M964_CPU_VARIANT")) {
+                auto requested = std::optional<CpuVariant>{};
+
+                for (const auto candidate : { CpuVariant::Generic, CpuVariant::AVX2, CpuVariant::AVX512 })
+                    if (std::strcmp(forced, cpu_variant_name(candidate)) == 0)
+                        requested = candidate;
+
+                if (!requested)
+                    std::cerr << "Warning: Unknown M964_CPU_VARIANT " << forced << ", using " << cpu_variant_name(variant) << std::endl;
+                else if (!is_supported(*requested))
+                    std::cerr << "Warning: M964_CPU_VARIANT " << forced << " is not supported here, using " << cpu_variant_name(variant) << std::endl;
+                else
+                    variant = *requested;
+            }
+
+            return kernel_table(variant);
+        }
+    }
+
+    auto cpu_variant_name(const CpuVariant& variant) -> const char* {
+        switch (variant) {
+            case CpuVariant::Generic: return "generic";
+            case CpuVariant::AVX2: return "avx2";
+            case CpuVariant::AVX512: return "avx512";
+        }
+
+        return "unknown";
+    }
+
+    auto supported_cpu_variant() -> CpuVariant {
+        for (const auto variant : { CpuVariant::AVX512, CpuVariant::AVX2 })
+            if (is_supported(variant))
+                return variant;
+
+        return CpuVariant::Generic;
+    }
+
+    auto active_kernels() -> const KernelTable& {
+        static const auto kernels = select_kernels();
+        return kernels;
+    }
+}
@@ -0,0 +1,301 @@
+#include "dataset.h"
+
+#include <cmath>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <filesystem>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "stb_image.h"
+
+namespace m964 {
+    namespace {
+        constexpr char IMAGE_CACHE_MAGIC[8] = { 'M', '9', '6', '4', 'I', 'M', 'G', 'C' };
+        constexpr std::uint32_t IMAGE_CACHE_VERSION = 1;
+
+        struct ImageCacheHeader {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t channel_count;
+            std::uint64_t width;
+            std::uint64_t height;
+        };
+
+        struct ResampleTap {
+            std::size_t index;
+            float weight;
+        };
+
+        auto channel_count(const ImageChannels& channels) -> std::size_t {
+            switch (channels) {
+                case ImageChannels::Grayscale: return 1;
+                case ImageChannels::RGB: return 3;
+                case ImageChannels::RGBA: return 4;
+            }
+
+            return 1;
+        }
+
+        auto resample_taps(const std::size_t& source_size, const std::size_t& target_size, const ResizeFilter& filter) -> std::vector<std::vector<ResampleTap>> {
+            auto taps = std::vector<std::vector<ResampleTap>>(target_size);
+            const auto scale = static_cast<double>(source_size) / static_cast<double>(target_size);
+
+            for (std::size_t i = 0; i < target_size; ++i) {
+                if (filter == ResizeFilter::Box && target_size < source_size) {
+                    // Average over the source interval covered by this target cell, weighting partially covered cells
+                    const auto begin = static_cast<double>(i) * scale;
+                    const auto end = static_cast<double>(i + 1) * scale;
+
+                    for (auto s = static_cast<std::size_t>(begin); s < source_size && static_cast<double>(s) < end; ++s) {
+                        const auto coverage = std::min(end, static_cast<double>(s + 1)) - std::max(begin, static_cast<double>(s));
+                        taps[i].push_back({ s, static_cast<float>(coverage / scale) });
+                    }
+                } else {
+                    const auto center = std::clamp((static_cast<double>(i) + 0.5) * scale - 0.5, 0.0, static_cast<double>(source_size - 1));
+                    const auto left = static_cast<std::size_t>(center);
+                    const auto right = std::min(left + 1, source_size - 1);
+                    const auto fraction = static_cast<float>(center - static_cast<double>(left));
+
+                    taps[i].push_back({ left, 1.0f - fraction });
+                    if (right != left)
+                        taps[i].push_back({ right, fraction });
+                }
+            }
+
+            return taps;
+        }
+
+        auto hash_bytes(std::uint64_t hash, const void* data, const std::size_t& size) -> std::uint64_t {
+            const auto* bytes = static_cast<const unsigned char*>(data);
+
+            for (std::size_t i = 0; i < size; ++i) {
+                hash ^= bytes[i];
+                hash *= 1099511628211ull;
+            }
+
+            return hash;
+        }
+
+        auto cache_file_name(const std::string& file_name, const ImagePreprocessing& preprocessing, const std::string& cache_directory) -> std::optional<std::string> {
+            auto error = std::error_code{};
+            const auto path = std::filesystem::absolute(file_name, error).string();
+            const auto size = std::filesystem::file_size(file_name, error);
+            if (error)
+                return std::nullopt;
+
+            const auto modified = std::filesystem::last_write_time(file_name, error).time_since_epoch().count();
+            if (error)
+                return std::nullopt;
+
+            const std::uint64_t settings[] = {
+                IMAGE_CACHE_VERSION,
+                size,
+                static_cast<std::uint64_t>(modified),
+                preprocessing.width,
+                preprocessing.height,
+                static_cast<std::uint64_t>(preprocessing.channels),
+                preprocessing.invert ? 1u : 0u,
+                static_cast<std::uint64_t>(preprocessing.filter)
+            };
+
+            auto hash = 14695981039346656037ull;
+            hash = hash_bytes(hash, path.data(), path.size());
+            hash = hash_bytes(hash, settings, sizeof(settings));
+
+            char name[32];
+            std::snprintf(name, sizeof(name), "%016llx.m964img", static_cast<unsigned long long>(hash));
+
+            return (std::filesystem::path(cache_directory) / name).string();
+        }
+
+        auto read_cache(const std::string& cache_name) -> std::optional<ImageTarget> {
+            const auto fd = ::open(cache_name.c_str(), O_RDONLY);
+            if (fd < 0)
+                return std::nullopt;
+
+            struct stat info{};
+            if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(ImageCacheHeader)) {
+                ::close(fd);
+                return std::nullopt;
+            }
+
+            const auto file_size = static_cast<std::size_t>(info.st_size);
+            auto* mapping = ::mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+
+            if (mapping == MAP_FAILED)
+                return std::nullopt;
+
+            auto header = ImageCacheHeader{};
+            std::memcpy(&header, mapping, sizeof(header));
+
+            const auto cell_count = header.width * header.height;
+            const auto valid = std::memcmp(header.magic, IMAGE_CACHE_MAGIC, sizeof(header.magic)) == 0
+                && header.version == IMAGE_CACHE_VERSION
+                && file_size == sizeof(header) + cell_count * header.channel_count * sizeof(float);
+
+            auto target = std::optional<ImageTarget>{};
+
+            if (valid) {
+                target = ImageTarget{ header.width, header.height, {} };
+                const auto* values = reinterpret_cast<const float*>(static_cast<const char*>(mapping) + sizeof(header));
+
+                for (std::uint32_t c = 0; c < header.channel_count; ++c) {
+                    auto& channel = target->channels.emplace_back(header.width, header.height);
+                    std::memcpy(channel.data(), values + c * cell_count, cell_count * sizeof(float));
+                }
+            }
+
+            ::munmap(mapping, file_size);
+            return target;
+        }
+
+        auto write_cache(const std::string& cache_name, const ImageTarget& target) -> void {
+            auto error = std::error_code{};
+            std::filesystem::create_directories(std::filesystem::path(cache_name).parent_path(), error);
+
+            const auto temporary_name = cache_name + ".tmp";
+
+            {
+                std::ofstream stream(temporary_name, std::ios::binary | std::ios::trunc);
+
+                auto header = ImageCacheHeader{};
+                std::memcpy(header.magic, IMAGE_CACHE_MAGIC, sizeof(header.magic));
+                header.version = IMAGE_CACHE_VERSION;
+                header.channel_count = static_cast<std::uint32_t>(target.channels.size());
+                header.width = target.width;
+                header.height = target.height;
+
+                stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                for (const auto& channel : target.channels)
+                    stream.write(reinterpret_cast<const char*>(channel.data()), static_cast<std::streamsize>(channel.size() * sizeof(float)));
+
+                if (!stream.flush()) {
+                    std::cerr << "Warning [load_image_target]: Could not write image cache " << temporary_name << std::endl;
+                    return;
+                }
+            }
+
+            std::filesystem::rename(temporary_name, cache_name, error);
+            if (error)
+                std::cerr << "Warning [load_image_target]: Could not write image cache " << cache_name << ": " << error.message() << std::endl;
+        }
+
+        auto decode_image(const std::string& file_name, const ImagePreprocessing& preprocessing) -> std::optional<ImageTarget> {
+            int w, h, channels_in_file;
+            unsigned char* pixels = stbi_load(file_name.c_str(), &w, &h, &channels_in_file, STBI_rgb_alpha);
+
+            if (!pixels) {
+                std::cerr << "ERROR: Could not load image " << file_name << " - " << stbi_failure_reason() << std::endl;
+                return std::nullopt;
+            }
+
+            const auto width = static_cast<std::size_t>(w);
+            const auto height = static_cast<std::size_t>(h);
+            const auto count = channel_count(preprocessing.channels);
+
+            auto decoded = std::vector<Layer>(count, Layer(width, height));
+
+            for (std::size_t y = 0; y < height; ++y) {
+                for (std::size_t x = 0; x < width; ++x) {
+                    const unsigned char* p = pixels + (y * width + x) * 4;
+
+                    for (std::size_t c = 0; c < count; ++c) {
+                        auto value = preprocessing.channels == ImageChannels::Grayscale
+                            ? (0.299f * p[0] + 0.587f * p[1] + 0.114f * p[2]) / 255.0f
+                            : static_cast<float>(p[c]) / 255.0f;
+
+                        decoded[c](x, y) = preprocessing.invert ? 1.0f - value : value;
+                    }
+                }
+            }
+
+            stbi_image_free(pixels);
+
+            const auto target_width = preprocessing.width > 0 ? preprocessing.width : width;
+            const auto target_height = preprocessing.height > 0 ? preprocessing.height : height;
+
+            auto target = ImageTarget{ target_width, target_height, {} };
+
+            for (auto& channel : decoded) {
+                if (target_width == width && target_height == height)
+                    target.channels.push_back(std::move(channel));
+                else
+                    target.channels.push_back(resize_layer(channel, target_width, target_height, preprocessing.filter));
+            }
+
+            return target;
+        }
+    }
+
+    auto ImageTarget::is_valid() const -> bool {
+        return width > 0 && height > 0 && !channels.empty();
+    }
+
+    auto resize_layer(const Layer& source, const std::size_t& width, const std::size_t& height, const ResizeFilter& filter) -> Layer {
+        const auto source_width = source.get_width();
+        const auto source_height = source.get_height();
+
+        const auto horizontal = resample_taps(source_width, width, filter);
+        const auto vertical = resample_taps(source_height, height, filter);
+
+        auto intermediate = Layer(width, source_height);
+        for (std::size_t y = 0; y < source_height; ++y) {
+            for (std::size_t x = 0; x < width; ++x) {
+                auto value = 0.0f;
+                for (const auto& tap : horizontal[x])
+                    value += source(tap.index, y) * tap.weight;
+
+                intermediate(x, y) = value;
+            }
+        }
+
+        auto result = Layer(width, height);
+        for (std::size_t y = 0; y < height; ++y) {
+            for (std::size_t x = 0; x < width; ++x) {
+                auto value = 0.0f;
+                for (const auto& tap : vertical[y])
+                    value += intermediate(x, tap.index) * tap.weight;
+
+                result(x, y) = value;
+            }
+        }
+
+        return result;
+    }
+
+    auto load_image_target(const std::string& file_name, const ImagePreprocessing& preprocessing, const std::string& cache_directory) -> std::optional<ImageTarget> {
+        const auto cache_name = cache_directory.empty() ? std::nullopt : cache_file_name(file_name, preprocessing, cache_directory);
+
+        if (cache_name) {
+            if (auto cached = read_cache(*cache_name))
+                return cached;
+        }
+
+        auto target = decode_image(file_name, preprocessing);
+
+        if (target && cache_name)
+            write_cache(*cache_name, *target);
+
+        return target;
+    }
+
+    auto load_image_dataset(const std::vector<std::string>& file_names, const ImagePreprocessing& preprocessing, const std::string& cache_directory) -> std::vector<ImageTarget> {
+        auto dataset = std::vector<ImageTarget>{};
+        dataset.reserve(file_names.size());
+
+        for (const auto& file_name : file_names) {
+            if (auto target = load_image_target(file_name, preprocessing, cache_directory))
+                dataset.push_back(std::move(*target));
+        }
+
+        return dataset;
+    }
+}
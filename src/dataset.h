@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <optional>
+
+#include "layer.h"
+
+namespace m964 {
+    enum class ImageChannels {
+        Grayscale,
+        RGB,
+        RGBA
+    };
+
+    enum class ResizeFilter {
+        Box,
+        Bilinear
+    };
+
+    struct ImagePreprocessing {
+        std::size_t width = 0;  // 0 keeps the source width
+        std::size_t height = 0; // 0 keeps the source height
+        ImageChannels channels = ImageChannels::Grayscale;
+        bool invert = true;     // 1 - value, dark pixels become active cells
+        ResizeFilter filter = ResizeFilter::Box;
+    };
+
+    struct ImageTarget {
+        std::size_t width = 0;
+        std::size_t height = 0;
+        std::vector<Layer> channels;
+
+        [[nodiscard]] auto is_valid() const -> bool;
+    };
+
+    // Box averages when shrinking an axis and interpolates bilinearly otherwise, unless Bilinear is forced
+    auto resize_layer(const Layer& source, const std::size_t& width, const std::size_t& height, const ResizeFilter& filter = ResizeFilter::Box) -> Layer;
+
+    // Decodes once and keeps the preprocessed floats in <cache_directory>, keyed by the source path, its size and
+    // modification time and the preprocessing settings. Later runs memory-map the cache instead of decoding.
+    // An empty cache_directory disables the cache.
+    auto load_image_target(
+        const std::string& file_name,
+        const ImagePreprocessing& preprocessing = {},
+        const std::string& cache_directory = ".m964_cache"
+    ) -> std::optional<ImageTarget>;
+
+    // Images that fail to load are skipped with an error message
+    auto load_image_dataset(
+        const std::vector<std::string>& file_names,
+        const ImagePreprocessing& preprocessing = {},
+        const std::string& cache_directory = ".m964_cache"
+    ) -> std::vector<ImageTarget>;
+}
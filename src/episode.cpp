@@ -0,0 +1,217 @@
+#include "episode.h"
+
+#include <utility>
+#include <algorithm>
+#include <thread>
+
+namespace m964 {
+    auto Episode::promise_type::get_return_object() -> Episode {
+        return Episode(Handle::from_promise(*this));
+    }
+
+    Episode::Episode(Handle handle) : handle(handle) {
+
+    }
+
+    Episode::Episode(Episode&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {
+
+    }
+
+    auto Episode::operator=(Episode&& other) noexcept -> Episode& {
+        if (this != &other) {
+            if (handle)
+                handle.destroy();
+
+            handle = std::exchange(other.handle, nullptr);
+        }
+
+        return *this;
+    }
+
+    Episode::~Episode() {
+        if (handle)
+            handle.destroy();
+    }
+
+    auto Episode::done() const -> bool {
+        return !handle || handle.done();
+    }
+
+    auto Episode::resume() -> void {
+        handle.promise().model = nullptr;
+        handle.resume();
+    }
+
+    auto Episode::request() const -> StepRequest {
+        const auto& promise = handle.promise();
+        return StepRequest{ promise.model, promise.steps, promise.biases };
+    }
+
+    auto Episode::step() -> void {
+        auto& promise = handle.promise();
+        if (promise.model == nullptr)
+            return;
+
+        for (std::size_t t = 0; t < promise.steps; ++t) {
+            if (promise.biases)
+                promise.model->simulate_step_with_biases();
+            else
+                promise.model->simulate_step();
+        }
+    }
+
+    auto Episode::cost() const -> float {
+        const auto& promise = handle.promise();
+        if (promise.exception)
+            std::rethrow_exception(promise.exception);
+
+        return promise.cost;
+    }
+
+    auto StepModelAwaiter::await_suspend(Episode::Handle handle) const noexcept -> void {
+        auto& promise = handle.promise();
+        promise.model = &model;
+        promise.steps = steps;
+        promise.biases = biases;
+    }
+
+    auto step_model(Model& model, const std::size_t& steps, const bool& biases) -> StepModelAwaiter {
+        return StepModelAwaiter{ model, steps, biases };
+    }
+
+    auto read_probe(Model& model, const std::size_t& x, const std::size_t& y) -> ReadProbeAwaiter {
+        return ReadProbeAwaiter{ model.get_new_state()(x, y) };
+    }
+
+    EpisodeScheduler::EpisodeScheduler(const std::size_t& max_in_flight) : max_in_flight(std::max<std::size_t>(max_in_flight, 1)) {
+
+    }
+
+    auto EpisodeScheduler::add(Episode episode) -> std::size_t {
+        episodes.push_back(std::move(episode));
+        return episodes.size() - 1;
+    }
+
+    auto EpisodeScheduler::run() -> std::vector<float> {
+        auto costs = std::vector<float>(episodes.size(), 0.0f);
+
+        auto ready = std::vector<std::size_t>{};
+        auto suspended = std::vector<std::size_t>{};
+        ready.reserve(max_in_flight);
+        suspended.reserve(max_in_flight);
+
+        std::size_t next = 0;
+
+        while (next < episodes.size() || !ready.empty()) {
+            while (ready.size() < max_in_flight && next < episodes.size())
+                ready.push_back(next++);
+
+            // Environment logic of every episode in flight up to its next step request
+            for (const auto& i : ready) {
+                episodes[i].resume();
+
+                if (episodes[i].done())
+                    costs[i] = episodes[i].cost();
+                else
+                    suspended.push_back(i);
+            }
+
+            step_batched(suspended);
+
+            std::swap(ready, suspended);
+            suspended.clear();
+        }
+
+        episodes.clear();
+
+        return costs;
+    }
+
+    auto EpisodeScheduler::step_batched(const std::vector<std::size_t>& suspended) -> void {
+        auto pending = std::vector<Episode::StepRequest>{};
+        pending.reserve(suspended.size());
+
+        for (const auto& i : suspended)
+            pending.push_back(episodes[i].request());
+
+        auto done = std::vector<bool>(suspended.size(), false);
+        auto group = std::vector<Model*>{};
+
+        for (std::size_t first = 0; first < pending.size(); ++first) {
+            if (done[first])
+                continue;
+
+            const auto& request = pending[first];
+            const auto batchable = request.model != nullptr && request.model->width >= 3 && request.model->height >= 3 && request.model->has_states();
+
+            // Every later request that can share a batch with this one
+            group.clear();
+
+            for (auto j = first; j < pending.size() && batchable; ++j) {
+                const auto& other = pending[j];
+
+                if (done[j] || other.model == nullptr || other.steps != request.steps || other.biases != request.biases || !other.model->has_states())
+                    continue;
+
+                if (other.model->width != request.model->width || other.model->height != request.model->height)
+                    continue;
+
+                if (std::find(group.begin(), group.end(), other.model) != group.end())
+                    continue; // two episodes on one model have to step it one after the other
+
+                group.push_back(other.model);
+                done[j] = true;
+            }
+
+            if (group.size() < 2) {
+                episodes[suspended[first]].step();
+                done[first] = true;
+                continue;
+            }
+
+            auto batch = std::find_if(batches.begin(), batches.end(), [&](const auto& candidate) {
+                return candidate.get_width() == request.model->width && candidate.get_height() == request.model->height;
+            });
+
+            if (batch == batches.end())
+                batch = batches.emplace(batches.end(), request.model->width, request.model->height);
+
+            for (std::size_t offset = 0; offset < group.size(); offset += MODEL_BATCH_LANES) {
+                const auto count = std::min(MODEL_BATCH_LANES, group.size() - offset);
+                batch->step(std::span<Model* const>(group.data() + offset, count), request.steps, request.biases);
+            }
+        }
+    }
+
+    auto evaluate_episodes(std::vector<Model>& models, const EpisodeFactory& factory, const std::size_t& thread_count, const std::size_t& max_in_flight) -> std::vector<float> {
+        auto costs = std::vector<float>(models.size(), 0.0f);
+
+        const auto threads = thread_count > 0 ? thread_count : std::max(1u, std::thread::hardware_concurrency());
+        const auto slice_count = std::max<std::size_t>(1, std::min<std::size_t>(models.size(), threads));
+        const auto executor = ParallelExecutor(slice_count);
+
+        auto slices = std::vector<std::pair<std::size_t, std::size_t>>{};
+        for (std::size_t s = 0; s < slice_count; ++s)
+            slices.emplace_back(models.size() * s / slice_count, models.size() * (s + 1) / slice_count);
+
+        executor.execute(slices.begin(), slices.end(), [&](const std::pair<std::size_t, std::size_t>& slice) {
+            auto scheduler = EpisodeScheduler(max_in_flight);
+
+            for (auto i = slice.first; i < slice.second; ++i)
+                scheduler.add(factory(models[i]));
+
+            const auto slice_costs = scheduler.run();
+            std::copy(slice_costs.begin(), slice_costs.end(), costs.begin() + static_cast<std::ptrdiff_t>(slice.first));
+        });
+
+        return costs;
+    }
+
+    auto episode_cost(EpisodeFactory factory) -> std::function<float(Model&)> {
+        return [factory = std::move(factory)](Model& model) {
+            auto scheduler = EpisodeScheduler{};
+            scheduler.add(factory(model));
+            return scheduler.run().front();
+        };
+    }
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <coroutine>
+#include <exception>
+#include <functional>
+
+#include "model.h"
+#include "model_batch.h"
+#include "parallel_executor.h"
+
+namespace m964 {
+    // Cost function written as a coroutine: it runs the environment logic itself and co_awaits step_model() whenever
+    // the model has to advance, which hands the steps to the EpisodeScheduler. co_return delivers the cost.
+    class Episode {
+        public:
+            struct promise_type {
+                float cost = 0.0f;
+                std::exception_ptr exception;
+
+                // Step request of the suspended episode
+                Model* model = nullptr;
+                std::size_t steps = 0;
+                bool biases = true;
+
+                auto get_return_object() -> Episode;
+                auto initial_suspend() noexcept -> std::suspend_always { return {}; }
+                auto final_suspend() noexcept -> std::suspend_always { return {}; }
+                auto return_value(const float& value) -> void { cost = value; }
+                auto unhandled_exception() -> void { exception = std::current_exception(); }
+            };
+
+            using Handle = std::coroutine_handle<promise_type>;
+
+        private:
+            Handle handle;
+
+        public:
+            explicit Episode(Handle handle);
+            Episode(Episode&& other) noexcept;
+            auto operator=(Episode&& other) noexcept -> Episode&;
+            Episode(const Episode&) = delete;
+            auto operator=(const Episode&) -> Episode& = delete;
+            ~Episode();
+
+            [[nodiscard]] auto done() const -> bool;
+            auto resume() -> void;
+
+            // The pending step request, model is null when there is none
+            struct StepRequest {
+                Model* model;
+                std::size_t steps;
+                bool biases;
+            };
+
+            [[nodiscard]] auto request() const -> StepRequest;
+
+            // Runs the pending step request
+            auto step() -> void;
+
+            // Rethrows what the coroutine threw
+            [[nodiscard]] auto cost() const -> float;
+    };
+
+    struct StepModelAwaiter {
+        Model& model;
+        std::size_t steps;
+        bool biases;
+
+        auto await_ready() const noexcept -> bool { return steps == 0; }
+        auto await_suspend(Episode::Handle handle) const noexcept -> void;
+        auto await_resume() const noexcept -> void {}
+    };
+
+    struct ReadProbeAwaiter {
+        float value;
+
+        auto await_ready() const noexcept -> bool { return true; }
+        auto await_suspend(Episode::Handle) const noexcept -> void {}
+        auto await_resume() const noexcept -> float { return value; }
+    };
+
+    // co_await step_model(model, k) runs k steps (with biases unless told otherwise) of the model
+    auto step_model(Model& model, const std::size_t& steps, const bool& biases = true) -> StepModelAwaiter;
+
+    // co_await read_probe(model, x, y) reads cell (x, y) of model.get_new_state(), like the example cost functions
+    auto read_probe(Model& model, const std::size_t& x, const std::size_t& y) -> ReadProbeAwaiter;
+
+    using EpisodeFactory = std::function<Episode(Model&)>;
+
+    // Interleaves episodes on one thread: resumes every episode in flight until its next step request, then runs the
+    // steps of all of them and starts over. Requests of the same size, step count and bias flag are stepped together
+    // in a ModelBatch of up to MODEL_BATCH_LANES models, a request that has no partner is stepped on its own model.
+    // At most max_in_flight episodes are in flight, a finished episode makes room for the next one.
+    class EpisodeScheduler {
+        private:
+            std::vector<Episode> episodes;
+            std::size_t max_in_flight;
+            std::vector<ModelBatch> batches; // one per model size
+
+            auto step_batched(const std::vector<std::size_t>& suspended) -> void;
+
+        public:
+            explicit EpisodeScheduler(const std::size_t& max_in_flight = 2 * MODEL_BATCH_LANES);
+
+            auto add(Episode episode) -> std::size_t;
+
+            // Costs in the order the episodes were added
+            auto run() -> std::vector<float>;
+    };
+
+    // One episode per model, each of thread_count threads (0 uses std::thread::hardware_concurrency()) runs an
+    // EpisodeScheduler over its share of the models
+    auto evaluate_episodes(std::vector<Model>& models, const EpisodeFactory& factory, const std::size_t& thread_count = 0, const std::size_t& max_in_flight = 2 * MODEL_BATCH_LANES) -> std::vector<float>;
+
+    // Plain cost callback for the trainers, runs a single episode to completion. There is nothing to batch it with,
+    // use evaluate_episodes() for a whole population
+    auto episode_cost(EpisodeFactory factory) -> std::function<float(Model&)>;
+}
@@ -0,0 +1,136 @@
+#include "evaluation.h"
+#include "light_cone.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace m964 {
+    namespace {
+        auto check_sample(const Model& model, const EvaluationSample& sample) -> void {
+            const auto fits = [&](const Layer& layer) {
+                return layer.get_width() == model.width && layer.get_height() == model.height;
+            };
+
+            if ((sample.initial_state && !fits(*sample.initial_state)) || (sample.target && !fits(*sample.target)) || (sample.mask && !fits(*sample.mask)))
+                throw std::invalid_argument("evaluate: sample layer dimensions do not match the model");
+
+            for (const auto& injection : sample.injections)
+                if (injection.x >= model.width || injection.y >= model.height)
+                    throw std::invalid_argument("evaluate: injection cell is outside of the model");
+
+            for (const auto& probe : sample.probes)
+                if (probe.x >= model.width || probe.y >= model.height)
+                    throw std::invalid_argument("evaluate: probe cell is outside of the model");
+
+            if (sample.mask && !sample.target)
+                throw std::invalid_argument("evaluate: a mask needs a target layer");
+        }
+
+        auto step(Model& model, const bool& biases) -> void {
+            if (biases)
+                model.simulate_step_with_biases();
+            else
+                model.simulate_step();
+        }
+
+    }
+
+    auto sample_loss(const Layer& state, const EvaluationSample& sample, const EvaluationSpec& spec) -> float {
+        auto loss = 0.0f;
+
+        if (sample.target) {
+            if (sample.mask && spec.loss_kind == LossKind::SquaredError) {
+                loss += masked_mse_loss(state, *sample.target, *sample.mask, spec.reduction);
+            } else if (sample.mask) {
+                loss += masked_l1_loss(state, *sample.target, *sample.mask, spec.reduction);
+            } else if (spec.loss_kind == LossKind::SquaredError) {
+                loss += mse_loss(state, *sample.target, spec.reduction);
+            } else {
+                loss += l1_loss(state, *sample.target, spec.reduction);
+            }
+        }
+
+        if (!sample.probes.empty())
+            loss += probe_loss(state, sample.probes, spec.loss_kind, spec.reduction);
+
+        return loss;
+    }
+
+    auto evaluate(Model& model, const EvaluationSpec& spec, const float& cutoff) -> std::optional<float> {
+        const auto steps = spec.n_evolution_steps;
+        const auto every_step = spec.schedule == LossSchedule::EveryStep;
+
+        auto cost = 0.0f;
+
+        for (const auto& sample : spec.samples) {
+            check_sample(model, sample);
+
+            model.reset_states();
+
+            if (sample.initial_state)
+                std::copy(sample.initial_state->data(), sample.initial_state->data() + sample.initial_state->size(), model.get_old_state().data());
+            else if (spec.initial_value != 0.0f)
+                model.get_old_state().fill(spec.initial_value);
+
+            // simulate_step_with_loss always adds the biases, it scores the target while the rows are still in cache
+            const auto fused = sample.target.has_value() && spec.biases;
+            const auto* mask = sample.mask ? &*sample.mask : nullptr;
+
+            auto sample_cost = 0.0f;
+
+            // Only probes are read after the last step: compute just their light cone, the result is the same
+            if (!every_step && !sample.target && !sample.probes.empty() && steps > 0) {
+                const auto readout = probe_region(sample.probes);
+
+                for (std::size_t t = 0; t < steps; ++t) {
+                    auto& state = model.get_old_state();
+                    for (const auto& injection : sample.injections)
+                        state(injection.x, injection.y) = injection.value;
+
+                    simulate_step_region(model, light_cone(model.width, model.height, readout, t, steps), spec.biases);
+                }
+
+                cost += probe_loss(model.get_old_state(), sample.probes, spec.loss_kind, spec.reduction);
+
+                if (cost >= cutoff)
+                    return std::nullopt;
+
+                continue;
+            }
+
+            for (std::size_t t = 0; t < steps; ++t) {
+                auto& state = model.get_old_state();
+                for (const auto& injection : sample.injections)
+                    state(injection.x, injection.y) = injection.value;
+
+                if (!every_step && t + 1 < steps) {
+                    step(model, spec.biases);
+                    continue;
+                }
+
+                if (fused) {
+                    sample_cost += simulate_step_with_loss(model, *sample.target, spec.loss_kind, spec.reduction, mask);
+
+                    if (!sample.probes.empty())
+                        sample_cost += probe_loss(model.get_old_state(), sample.probes, spec.loss_kind, spec.reduction);
+                } else {
+                    step(model, spec.biases);
+                    sample_cost += sample_loss(model.get_old_state(), sample, spec);
+                }
+
+                if (every_step && cost + sample_cost / static_cast<float>(steps) >= cutoff)
+                    return std::nullopt;
+            }
+
+            if (steps == 0)
+                sample_cost = sample_loss(model.get_old_state(), sample, spec);
+
+            cost += every_step && steps > 0 ? sample_cost / static_cast<float>(steps) : sample_cost;
+
+            if (cost >= cutoff)
+                return std::nullopt;
+        }
+
+        return cost;
+    }
+}
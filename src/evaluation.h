@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <limits>
+#include <optional>
+
+#include "layer.h"
+#include "model.h"
+#include "loss.h"
+
+namespace m964 {
+    // Written into the state before every step, like an input that is held during the rollout
+    struct Injection {
+        std::size_t x;
+        std::size_t y;
+        float value;
+    };
+
+    enum class LossSchedule {
+        FinalStep, // loss of the state after the last step
+        EveryStep  // mean of the losses after every step
+    };
+
+    // One rollout of an evaluation, its losses are summed over all samples
+    struct EvaluationSample {
+        std::optional<Layer> initial_state = {}; // EvaluationSpec::initial_value everywhere when empty
+        std::vector<Injection> injections = {};
+
+        // Probe cells or a target layer (optionally masked) to score the state against
+        std::vector<ProbeCell> probes = {};
+        std::optional<Layer> target = {};
+        std::optional<Layer> mask = {};
+    };
+
+    // Declarative description of a cost function. Unlike an opaque callback the library knows what is read and written,
+    // so it can choose the implementation: fused step and loss passes, early abort once the cutoff is exceeded, ...
+    struct EvaluationSpec {
+        std::vector<EvaluationSample> samples = {};
+
+        std::size_t n_evolution_steps = 16;
+        bool biases = true;
+        float initial_value = 0.0f;
+
+        LossKind loss_kind = LossKind::SquaredError;
+        LossReduction reduction = LossReduction::Sum;
+        LossSchedule schedule = LossSchedule::FinalStep;
+    };
+
+    // Loss of one sample on a state, the target and probe losses added up
+    auto sample_loss(const Layer& state, const EvaluationSample& sample, const EvaluationSpec& spec) -> float;
+
+    // Scores the state after the last step (Model::get_old_state()). Returns std::nullopt as soon as the partial cost reaches
+    // the cutoff, since every loss is non-negative the full cost could not beat it anymore. Samples scored on probes only are
+    // rolled out on the light cone of their probes (see light_cone.h), the other cells are stale afterwards.
+    auto evaluate(Model& model, const EvaluationSpec& spec, const float& cutoff = std::numeric_limits<float>::infinity()) -> std::optional<float>;
+}
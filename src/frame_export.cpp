@@ -0,0 +1,210 @@
+#include "frame_export.h"
+
+#include <cstring>
+#include <iostream>
+
+#include "stb_image_write.h"
+
+namespace m964 {
+    namespace {
+        auto hue_to_rgb(const float& v1, const float& v2, float vH) -> float {
+            if (vH < 0)
+                vH += 1;
+
+            if (vH > 1)
+                vH -= 1;
+
+            if ((6 * vH) < 1)
+                return (v1 + (v2 - v1) * 6 * vH);
+
+            if ((2 * vH) < 1)
+                return v2;
+
+            if ((3 * vH) < 2)
+                return (v1 + (v2 - v1) * ((2.0f / 3) - vH) * 6);
+
+            return v1;
+        }
+
+        auto hsl_to_rgb(const float& H, const float& L, const float& S) -> std::uint32_t {
+            if (S == 0) {
+                const auto v = static_cast<std::uint32_t>(static_cast<std::uint8_t>(L * 255));
+                return (255u << 24) | (v << 16) | (v << 8) | v;
+            }
+
+            const auto hue = H / 360;
+            const auto v2 = (L < 0.5) ? (L * (1 + S)) : ((L + S) - (L * S));
+            const auto v1 = 2 * L - v2;
+
+            const auto r = static_cast<std::uint32_t>(static_cast<std::uint8_t>(255 * hue_to_rgb(v1, v2, hue + (1.0f / 3))));
+            const auto g = static_cast<std::uint32_t>(static_cast<std::uint8_t>(255 * hue_to_rgb(v1, v2, hue)));
+            const auto b = static_cast<std::uint32_t>(static_cast<std::uint8_t>(255 * hue_to_rgb(v1, v2, hue - (1.0f / 3))));
+
+            return (255u << 24) | (b << 16) | (g << 8) | r;
+        }
+    }
+
+    ColorMap::ColorMap(
+        const float& min_value,
+        const float& max_value,
+        const std::size_t& resolution
+    ) : min_value(min_value),
+        max_value(max_value),
+        scale(0.0f)
+    {
+        const auto entries = resolution > 1 ? resolution : 2;
+        const auto range = max_value > min_value ? max_value - min_value : 1.0f;
+
+        scale = static_cast<float>(entries - 1) / range;
+        table.resize(entries);
+
+        for (std::size_t i = 0; i < entries; ++i) {
+            const auto value = min_value + static_cast<float>(i) / scale;
+            table[i] = hsl_to_rgb((1 - value) * 255, 0.5f, 1.0f);
+        }
+    }
+
+    auto ColorMap::map(const float* values, std::uint32_t* pixels, const std::size_t& count) const -> void {
+        const auto last = static_cast<float>(table.size() - 1);
+        const auto* lut = table.data();
+
+        // Branch-free clamp, NaN ends up at the first entry
+        for (std::size_t i = 0; i < count; ++i) {
+            auto position = (values[i] - min_value) * scale + 0.5f;
+            position = position > 0.0f ? position : 0.0f;
+            position = position < last ? position : last;
+
+            pixels[i] = lut[static_cast<std::uint32_t>(position)];
+        }
+    }
+
+    auto ColorMap::operator()(const float& value) const -> std::uint32_t {
+        auto pixel = std::uint32_t{};
+        map(&value, &pixel, 1);
+        return pixel;
+    }
+
+    FrameExporter::FrameExporter(
+        const FrameExportParameters& parameters
+    ) : parameters(parameters),
+        color_map(parameters.min_value, parameters.max_value),
+        in_flight(0),
+        stopping(false),
+        written_frames(0),
+        dropped_frames(0)
+    {
+        if (this->parameters.queue_capacity == 0)
+            this->parameters.queue_capacity = 1;
+
+        const auto worker_count = parameters.worker_count > 0 ? parameters.worker_count : 1;
+
+        for (std::size_t i = 0; i < worker_count; ++i)
+            workers.emplace_back([this]() { run(); });
+    }
+
+    FrameExporter::~FrameExporter() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+
+        frame_available.notify_all();
+
+        for (auto& worker : workers)
+            if (worker.joinable())
+                worker.join();
+    }
+
+    auto FrameExporter::submit(const std::string& file_name, const Layer& state) -> bool {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        if (queue.size() >= parameters.queue_capacity) {
+            switch (parameters.drop_policy) {
+                case FrameDropPolicy::DropNewest:
+                    ++dropped_frames;
+                    return false;
+
+                case FrameDropPolicy::DropOldest:
+                    buffer_pool.push_back(std::move(queue.front().values));
+                    queue.pop_front();
+                    ++dropped_frames;
+                    break;
+
+                case FrameDropPolicy::Block:
+                    slot_available.wait(lock, [&]() { return queue.size() < parameters.queue_capacity; });
+                    break;
+            }
+        }
+
+        auto values = std::vector<float>{};
+        if (!buffer_pool.empty()) {
+            values = std::move(buffer_pool.back());
+            buffer_pool.pop_back();
+        }
+
+        values.resize(state.size());
+        std::memcpy(values.data(), state.data(), state.size() * sizeof(float));
+
+        queue.push_back(Frame{ file_name, state.get_width(), state.get_height(), std::move(values) });
+        lock.unlock();
+
+        frame_available.notify_one();
+        return true;
+    }
+
+    auto FrameExporter::flush() -> void {
+        std::unique_lock<std::mutex> lock(mutex);
+        slot_available.wait(lock, [&]() { return queue.empty() && in_flight == 0; });
+    }
+
+    auto FrameExporter::get_written_frames() const -> std::size_t {
+        return written_frames;
+    }
+
+    auto FrameExporter::get_dropped_frames() const -> std::size_t {
+        return dropped_frames;
+    }
+
+    auto FrameExporter::encode(const Frame& frame, std::vector<std::uint32_t>& pixels) const -> void {
+        const auto width = static_cast<int>(frame.width);
+        const auto height = static_cast<int>(frame.height);
+        const auto stride = width * static_cast<int>(sizeof(std::uint32_t));
+
+        pixels.resize(frame.values.size());
+        color_map.map(frame.values.data(), pixels.data(), frame.values.size());
+
+        const auto result = parameters.format == FrameFormat::PNG
+            ? stbi_write_png(frame.file_name.c_str(), width, height, 4, pixels.data(), stride)
+            : stbi_write_jpg(frame.file_name.c_str(), width, height, 4, pixels.data(), parameters.jpg_quality);
+
+        if (result == 0)
+            std::cerr << "Warning [FrameExporter]: Could not write " << frame.file_name << std::endl;
+    }
+
+    auto FrameExporter::run() -> void {
+        auto pixels = std::vector<std::uint32_t>{};
+        std::unique_lock<std::mutex> lock(mutex);
+
+        while (true) {
+            frame_available.wait(lock, [&]() { return stopping || !queue.empty(); });
+
+            if (queue.empty())
+                break;
+
+            auto frame = std::move(queue.front());
+            queue.pop_front();
+            ++in_flight;
+
+            lock.unlock();
+            slot_available.notify_all();
+
+            encode(frame, pixels);
+            ++written_frames;
+
+            lock.lock();
+            buffer_pool.push_back(std::move(frame.values));
+            --in_flight;
+            slot_available.notify_all();
+        }
+    }
+}
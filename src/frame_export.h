@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+#include "layer.h"
+
+namespace m964 {
+    // Precomputed hsl_to_rgb((1 - value) * 255, 0.5f, 1.0f) ramp as used by the examples, sampled at
+    // `resolution` points over [min_value, max_value]. Values outside the range are clamped.
+    class ColorMap {
+        private:
+            float min_value;
+            float max_value;
+            float scale;
+
+            std::vector<std::uint32_t> table;
+
+        public:
+            explicit ColorMap(const float& min_value = 0.0f, const float& max_value = 2.0f, const std::size_t& resolution = 4096);
+
+            auto map(const float* values, std::uint32_t* pixels, const std::size_t& count) const -> void;
+            auto operator()(const float& value) const -> std::uint32_t;
+    };
+
+    enum class FrameFormat {
+        JPG,
+        PNG
+    };
+
+    enum class FrameDropPolicy {
+        DropNewest, // the submitted frame is discarded when the queue is full
+        DropOldest, // the oldest queued frame is discarded to make room
+        Block       // the simulation waits for a free slot
+    };
+
+    struct FrameExportParameters {
+        std::size_t worker_count = 1;
+        std::size_t queue_capacity = 16;
+        FrameDropPolicy drop_policy = FrameDropPolicy::DropNewest;
+        FrameFormat format = FrameFormat::JPG;
+        int jpg_quality = 90;
+        float min_value = 0.0f;
+        float max_value = 2.0f;
+    };
+
+    // Bounded background export stage. submit() only copies the state into a pooled buffer,
+    // colour mapping and encoding happen on the worker threads.
+    class FrameExporter {
+        private:
+            struct Frame {
+                std::string file_name;
+                std::size_t width;
+                std::size_t height;
+                std::vector<float> values;
+            };
+
+            FrameExportParameters parameters;
+            ColorMap color_map;
+
+            std::deque<Frame> queue;
+            std::vector<std::vector<float>> buffer_pool;
+            std::size_t in_flight;
+            bool stopping;
+
+            std::mutex mutex;
+            std::condition_variable frame_available;
+            std::condition_variable slot_available;
+            std::vector<std::thread> workers;
+
+            std::atomic<std::size_t> written_frames;
+            std::atomic<std::size_t> dropped_frames;
+
+            auto run() -> void;
+            auto encode(const Frame& frame, std::vector<std::uint32_t>& pixels) const -> void;
+
+        public:
+            explicit FrameExporter(const FrameExportParameters& parameters = {});
+            ~FrameExporter();
+
+            FrameExporter(const FrameExporter&) = delete;
+            auto operator=(const FrameExporter&) -> FrameExporter& = delete;
+
+            // Returns false if the frame was dropped
+            auto submit(const std::string& file_name, const Layer& state) -> bool;
+            auto flush() -> void;
+
+            [[nodiscard]] auto get_written_frames() const -> std::size_t;
+            [[nodiscard]] auto get_dropped_frames() const -> std::size_t;
+    };
+}
@@ -0,0 +1,258 @@
+#include "incremental.h"
+
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+namespace m964 {
+    namespace {
+        auto copy_region(Layer& destination, const Layer& source, const CellRegion& region) -> void {
+            const auto width = source.get_width();
+
+            for (auto y = region.y_begin; y < region.y_end; ++y) {
+                const auto* row = source.data() + y * width;
+                std::copy(row + region.x_begin, row + region.x_end, destination.data() + y * width + region.x_begin);
+            }
+        }
+
+        auto inject(Layer& state, const std::vector<Injection>& injections) -> void {
+            for (const auto& injection : injections)
+                state(injection.x, injection.y) = injection.value;
+        }
+
+        auto fits(const Layer& layer, const Model& model) -> bool {
+            return layer.get_width() == model.width && layer.get_height() == model.height;
+        }
+    }
+
+    IncrementalEvaluator::IncrementalEvaluator(EvaluationSpec spec, const Model& parent)
+        : spec(std::move(spec)),
+          parent(parent),
+          scratch { Layer(parent.width, parent.height), Layer(parent.width, parent.height) } {
+        for (const auto& sample : this->spec.samples) {
+            if ((sample.initial_state && !fits(*sample.initial_state, parent)) || (sample.target && !fits(*sample.target, parent)) || (sample.mask && !fits(*sample.mask, parent)))
+                throw std::invalid_argument("IncrementalEvaluator: sample layer dimensions do not match the model");
+
+            for (const auto& injection : sample.injections)
+                if (injection.x >= parent.width || injection.y >= parent.height)
+                    throw std::invalid_argument("IncrementalEvaluator: injection cell is outside of the model");
+
+            for (const auto& probe : sample.probes)
+                if (probe.x >= parent.width || probe.y >= parent.height)
+                    throw std::invalid_argument("IncrementalEvaluator: probe cell is outside of the model");
+
+            auto target_divisor = 1.0f;
+            auto probe_divisor = 1.0f;
+
+            if (this->spec.reduction == LossReduction::Mean) {
+                target_divisor = sample.mask
+                    ? std::max(std::accumulate(sample.mask->data(), sample.mask->data() + sample.mask->size(), 0.0f), std::numeric_limits<float>::min())
+                    : static_cast<float>(parent.width * parent.height);
+
+                probe_divisor = 0.0f;
+                for (const auto& probe : sample.probes)
+                    probe_divisor += probe.weight;
+                probe_divisor = std::max(probe_divisor, std::numeric_limits<float>::min());
+            }
+
+            target_divisors.push_back(target_divisor);
+            probe_divisors.push_back(probe_divisor);
+        }
+
+        rollout_parent();
+    }
+
+    auto IncrementalEvaluator::rollout_parent() -> void {
+        const auto steps = spec.n_evolution_steps;
+        const auto every_step = spec.schedule == LossSchedule::EveryStep;
+        const auto full = CellRegion { 0, parent.width, 0, parent.height };
+
+        trajectories.resize(spec.samples.size());
+        patches.resize(spec.samples.size());
+        sample_costs.assign(spec.samples.size(), 0.0f);
+        parent_cost = 0.0f;
+        has_child = false;
+
+        for (std::size_t s = 0; s < spec.samples.size(); ++s) {
+            const auto& sample = spec.samples[s];
+            auto& trajectory = trajectories[s];
+
+            trajectory.assign(steps + 1, Layer(parent.width, parent.height));
+            patches[s].resize(steps + 1);
+
+            if (sample.initial_state)
+                copy_region(trajectory[0], *sample.initial_state, full);
+            else
+                trajectory[0].fill(spec.initial_value);
+
+            for (std::size_t t = 1; t <= steps; ++t) {
+                copy_region(scratch[0], trajectory[t - 1], full);
+                inject(scratch[0], sample.injections);
+
+                step_region(trajectory[t], scratch[0], parent, full, spec.biases);
+            }
+
+            auto cost = 0.0f;
+
+            if (every_step && steps > 0) {
+                for (std::size_t t = 1; t <= steps; ++t)
+                    cost += sample_loss(trajectory[t], sample, spec);
+                cost /= static_cast<float>(steps);
+            } else {
+                cost = sample_loss(trajectory[steps], sample, spec);
+            }
+
+            sample_costs[s] = cost;
+            parent_cost += cost;
+        }
+    }
+
+    auto IncrementalEvaluator::region_loss(const Layer& state, const std::size_t& s, const CellRegion& region) const -> float {
+        const auto& sample = spec.samples[s];
+        const auto squared = spec.loss_kind == LossKind::SquaredError;
+
+        const auto error = [&](const float& value, const float& target) {
+            const auto difference = value - target;
+            return squared ? difference * difference : std::fabs(difference);
+        };
+
+        auto target_loss = 0.0f;
+
+        if (sample.target) {
+            for (auto y = region.y_begin; y < region.y_end; ++y) {
+                for (auto x = region.x_begin; x < region.x_end; ++x) {
+                    const auto cell_error = error(state(x, y), (*sample.target)(x, y));
+                    target_loss += sample.mask ? (*sample.mask)(x, y) * cell_error : cell_error;
+                }
+            }
+        }
+
+        auto probe_loss = 0.0f;
+
+        for (const auto& probe : sample.probes)
+            if (probe.x >= region.x_begin && probe.x < region.x_end && probe.y >= region.y_begin && probe.y < region.y_end)
+                probe_loss += probe.weight * error(state(probe.x, probe.y), probe.target);
+
+        return target_loss / target_divisors[s] + probe_loss / probe_divisors[s];
+    }
+
+    auto IncrementalEvaluator::set_parent(const Model& model) -> float {
+        if (model.width != parent.width || model.height != parent.height)
+            throw std::invalid_argument("IncrementalEvaluator::set_parent: model dimensions do not match");
+
+        parent = model;
+        rollout_parent();
+
+        return parent_cost;
+    }
+
+    auto IncrementalEvaluator::evaluate(const Model& child, const CellRegion& mutated) -> float {
+        if (child.width != parent.width || child.height != parent.height)
+            throw std::invalid_argument("IncrementalEvaluator::evaluate: child dimensions do not match the parent");
+
+        const auto width = parent.width;
+        const auto height = parent.height;
+        const auto steps = spec.n_evolution_steps;
+        const auto every_step = spec.schedule == LossSchedule::EveryStep;
+
+        auto child_cost = 0.0f;
+
+        for (std::size_t s = 0; s < spec.samples.size(); ++s) {
+            const auto& sample = spec.samples[s];
+            const auto& trajectory = trajectories[s];
+
+            auto delta = 0.0f;
+
+            // Step t reads the previous state on the changed region grown by one more cell, the rest of it is the parent's
+            if (steps > 0) {
+                copy_region(scratch[0], trajectory[0], grow_region(mutated, 1, width, height));
+                inject(scratch[0], sample.injections);
+            }
+
+            for (std::size_t t = 1; t <= steps; ++t) {
+                const auto region = grow_region(mutated, t - 1, width, height);
+                const auto& previous = scratch[(t - 1) % 2];
+                auto& current = scratch[t % 2];
+
+                if (t < steps)
+                    copy_region(current, trajectory[t], grow_region(region, 2, width, height));
+
+                step_region(current, previous, child, region, spec.biases);
+
+                auto& patch = patches[s][t];
+                patch.region = region;
+                patch.values.resize((region.x_end - region.x_begin) * (region.y_end - region.y_begin));
+                for (auto y = region.y_begin; y < region.y_end; ++y) {
+                    const auto* row = current.data() + y * width;
+                    std::copy(row + region.x_begin, row + region.x_end, patch.values.data() + (y - region.y_begin) * (region.x_end - region.x_begin));
+                }
+
+                if (every_step || t == steps)
+                    delta += region_loss(current, s, region) - region_loss(trajectory[t], s, region);
+
+                if (t < steps)
+                    inject(current, sample.injections);
+            }
+
+            child_cost += sample_costs[s] + (every_step && steps > 0 ? delta / static_cast<float>(steps) : delta);
+        }
+
+        has_child = true;
+
+        return child_cost;
+    }
+
+    auto IncrementalEvaluator::accept(const Model& child) -> void {
+        if (!has_child) {
+            std::cerr << "Error [IncrementalEvaluator::accept]: No child was evaluated since the last parent." << std::endl;
+            return;
+        }
+
+        const auto steps = spec.n_evolution_steps;
+        const auto every_step = spec.schedule == LossSchedule::EveryStep;
+
+        parent = child;
+        parent_cost = 0.0f;
+
+        for (std::size_t s = 0; s < spec.samples.size(); ++s) {
+            auto& trajectory = trajectories[s];
+
+            for (std::size_t t = 1; t <= steps; ++t) {
+                const auto& patch = patches[s][t];
+                const auto patch_width = patch.region.x_end - patch.region.x_begin;
+
+                for (auto y = patch.region.y_begin; y < patch.region.y_end; ++y) {
+                    const auto* row = patch.values.data() + (y - patch.region.y_begin) * patch_width;
+                    std::copy(row, row + patch_width, trajectory[t].data() + y * parent.width + patch.region.x_begin);
+                }
+            }
+
+            // Recomputed from the patched rollout, so the rounding of the deltas does not pile up over many accepted children
+            auto cost = 0.0f;
+
+            if (every_step && steps > 0) {
+                for (std::size_t t = 1; t <= steps; ++t)
+                    cost += sample_loss(trajectory[t], spec.samples[s], spec);
+                cost /= static_cast<float>(steps);
+            } else {
+                cost = sample_loss(trajectory[steps], spec.samples[s], spec);
+            }
+
+            sample_costs[s] = cost;
+            parent_cost += cost;
+        }
+
+        has_child = false;
+    }
+
+    auto IncrementalEvaluator::get_parent() const -> const Model& {
+        return parent;
+    }
+
+    auto IncrementalEvaluator::get_parent_cost() const -> float {
+        return parent_cost;
+    }
+}
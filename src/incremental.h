@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "layer.h"
+#include "model.h"
+#include "evaluation.h"
+#include "light_cone.h"
+
+namespace m964 {
+    // Local search with sparse mutations (see mutate_model_tile): caches the whole rollout of the parent for every sample of
+    // the spec, so a child that only differs from it in a region of cells is re-evaluated on the forward influence cone of
+    // that region. Step t only recomputes the region grown by t - 1 cells, and the loss is only updated by its change on the
+    // recomputed cells. The result matches evaluate() up to float rounding of the summation order. Not thread safe, use one
+    // evaluator per thread.
+    class IncrementalEvaluator {
+        private:
+            struct Patch {
+                CellRegion region;
+                std::vector<float> values;
+            };
+
+            EvaluationSpec spec;
+            Model parent;
+            float parent_cost = 0.0f;
+
+            // trajectories[sample][t] is the state after step t (before the injections of the next step), t = 0 is the initial state
+            std::vector<std::vector<Layer>> trajectories;
+            std::vector<float> sample_costs;
+
+            // Divisors of LossReduction::Mean for the target and the probes of every sample, 1 for LossReduction::Sum
+            std::vector<float> target_divisors;
+            std::vector<float> probe_divisors;
+
+            Layer scratch[2];
+            std::vector<std::vector<Patch>> patches; // recomputed cells of the last child, per sample and step
+            bool has_child = false;
+
+            auto rollout_parent() -> void;
+            auto region_loss(const Layer& state, const std::size_t& sample, const CellRegion& region) const -> float;
+
+        public:
+            IncrementalEvaluator(EvaluationSpec spec, const Model& parent);
+
+            // Full rollout of a new parent, returns its cost
+            auto set_parent(const Model& model) -> float;
+
+            // Cost of a child that equals the parent outside of the mutated region
+            auto evaluate(const Model& child, const CellRegion& mutated) -> float;
+
+            // Makes the last evaluated child the parent by patching its recomputed cells into the cached rollouts
+            auto accept(const Model& child) -> void;
+
+            [[nodiscard]] auto get_parent() const -> const Model&;
+            [[nodiscard]] auto get_parent_cost() const -> float;
+    };
+}
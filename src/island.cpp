@@ -0,0 +1,381 @@
+#include "island.h"
+
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+#include <cerrno>
+#include <sstream>
+#include <chrono>
+
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/time.h>
+
+namespace m964 {
+    namespace {
+        constexpr char MIGRANT_MESSAGE_MAGIC[8] = { 'M', '9', '6', '4', 'M', 'I', 'G', 'R' };
+
+        struct MigrantHeader {
+            char magic[8];
+            std::uint64_t source_island;
+            std::uint64_t payload_size;
+            float cost;
+        };
+
+        auto make_address(const std::string& path, sockaddr_un& address) -> bool {
+            std::memset(&address, 0, sizeof(address));
+            address.sun_family = AF_UNIX;
+
+            if (path.size() >= sizeof(address.sun_path)) {
+                std::cerr << "Error [UnixSocketTransport]: Socket path " << path << " is too long." << std::endl;
+                return false;
+            }
+
+            std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+            return true;
+        }
+
+        // Fails once SO_SNDTIMEO passes without progress, or at the deadline if the peer reads too slowly
+        auto write_all(const int& fd, const char* data, std::size_t size, const std::chrono::steady_clock::time_point& deadline) -> bool {
+            while (size > 0) {
+                if (std::chrono::steady_clock::now() > deadline)
+                    return false;
+
+                const auto written = ::send(fd, data, size, MSG_NOSIGNAL);
+
+                if (written < 0 && errno == EINTR)
+                    continue;
+
+                if (written <= 0)
+                    return false;
+
+                data += written;
+                size -= static_cast<std::size_t>(written);
+            }
+
+            return true;
+        }
+
+        auto set_timeout(const int& fd, const int& option, const int& milliseconds) -> void {
+            const auto timeout = timeval{ milliseconds / 1000, (milliseconds % 1000) * 1000 };
+            ::setsockopt(fd, SOL_SOCKET, option, &timeout, sizeof(timeout));
+        }
+
+        // Fails once SO_RCVTIMEO passes without data, or at the deadline if the peer keeps trickling
+        auto read_all(const int& fd, char* data, std::size_t size, const std::chrono::steady_clock::time_point& deadline) -> bool {
+            while (size > 0) {
+                if (std::chrono::steady_clock::now() > deadline)
+                    return false;
+
+                const auto received = ::recv(fd, data, size, 0);
+
+                if (received < 0 && errno == EINTR)
+                    continue;
+
+                if (received <= 0)
+                    return false;
+
+                data += received;
+                size -= static_cast<std::size_t>(received);
+            }
+
+            return true;
+        }
+    }
+
+    UnixSocketTransport::UnixSocketTransport(
+        const std::size_t& island_id,
+        const std::string& socket_directory,
+        const std::size_t& max_payload_size
+    ) : island_id(island_id),
+        socket_directory(socket_directory),
+        max_payload_size(max_payload_size),
+        listen_socket(-1),
+        stopping(false)
+    {
+        sender = std::thread([this]() { run_sender(); });
+
+        const auto path = socket_path(island_id);
+        auto address = sockaddr_un{};
+
+        if (!make_address(path, address))
+            return;
+
+        listen_socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        ::unlink(path.c_str());
+
+        if (listen_socket < 0 || ::bind(listen_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || ::listen(listen_socket, 16) != 0) {
+            std::cerr << "Error [UnixSocketTransport]: Could not listen on " << path << ": " << std::strerror(errno) << std::endl;
+
+            if (listen_socket >= 0)
+                ::close(listen_socket);
+
+            listen_socket = -1;
+            return;
+        }
+
+        receiver = std::thread([this]() { run(); });
+    }
+
+    UnixSocketTransport::~UnixSocketTransport() {
+        {
+            std::lock_guard<std::mutex> lock(outbox_mutex);
+            stopping = true;
+        }
+
+        outbox_ready.notify_all();
+
+        if (sender.joinable())
+            sender.join();
+
+        if (receiver.joinable())
+            receiver.join();
+
+        if (listen_socket >= 0) {
+            ::close(listen_socket);
+            ::unlink(socket_path(island_id).c_str());
+        }
+    }
+
+    auto UnixSocketTransport::socket_path(const std::size_t& island) const -> std::string {
+        return socket_directory + "/m964_island_" + std::to_string(island) + ".sock";
+    }
+
+    auto UnixSocketTransport::send(const std::size_t& destination, const Model& model, const float& cost) -> void {
+        std::ostringstream payload;
+        model.save(payload);
+        const auto serialized = payload.str();
+
+        auto header = MigrantHeader{};
+        std::memcpy(header.magic, MIGRANT_MESSAGE_MAGIC, sizeof(header.magic));
+        header.source_island = island_id;
+        header.payload_size = serialized.size();
+        header.cost = cost;
+
+        auto message = std::string(reinterpret_cast<const char*>(&header), sizeof(header));
+        message += serialized;
+
+        {
+            std::lock_guard<std::mutex> lock(outbox_mutex);
+
+            // A newer best model supersedes one that still waits for the same island
+            const auto pending = std::find_if(outbox.begin(), outbox.end(), [&](const auto& migrant) { return migrant.destination == destination; });
+
+            if (pending != outbox.end())
+                pending->message = std::move(message);
+            else
+                outbox.push_back(OutgoingMigrant{ destination, std::move(message) });
+        }
+
+        outbox_ready.notify_one();
+    }
+
+    auto UnixSocketTransport::run_sender() -> void {
+        while (true) {
+            auto migrant = OutgoingMigrant{};
+
+            {
+                std::unique_lock<std::mutex> lock(outbox_mutex);
+                outbox_ready.wait(lock, [&]() { return stopping || !outbox.empty(); });
+
+                if (stopping)
+                    return;
+
+                migrant = std::move(outbox.front());
+                outbox.pop_front();
+            }
+
+            if (!deliver(migrant))
+                std::cerr << "Warning [UnixSocketTransport]: Migration to island " << migrant.destination << " timed out or was interrupted, the migrant was dropped." << std::endl;
+        }
+    }
+
+    auto UnixSocketTransport::deliver(const OutgoingMigrant& migrant) const -> bool {
+        auto address = sockaddr_un{};
+        if (!make_address(socket_path(migrant.destination), address))
+            return true;
+
+        const auto fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0)
+            return true;
+
+        // SO_SNDTIMEO also bounds connect on a full backlog
+        set_timeout(fd, SO_SNDTIMEO, MIGRANT_IO_TIMEOUT_MS);
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(MIGRANT_MESSAGE_TIMEOUT_MS);
+
+        // The destination island may not be up yet, migration is best effort
+        auto delivered = true;
+
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0)
+            delivered = write_all(fd, migrant.message.data(), migrant.message.size(), deadline);
+        else
+            delivered = errno != EAGAIN && errno != EINPROGRESS;
+
+        ::close(fd);
+
+        return delivered;
+    }
+
+    auto UnixSocketTransport::receive() -> std::vector<MigrantModel> {
+        std::lock_guard<std::mutex> lock(inbox_mutex);
+        return std::exchange(inbox, {});
+    }
+
+    auto UnixSocketTransport::run() -> void {
+        while (!stopping) {
+            auto descriptor = pollfd{ listen_socket, POLLIN, 0 };
+
+            if (::poll(&descriptor, 1, 100) <= 0)
+                continue;
+
+            const auto fd = ::accept(listen_socket, nullptr, nullptr);
+            if (fd < 0)
+                continue;
+
+            set_timeout(fd, SO_RCVTIMEO, MIGRANT_IO_TIMEOUT_MS);
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(MIGRANT_MESSAGE_TIMEOUT_MS);
+
+            // Nothing may escape the thread, std::terminate would take the whole island down
+            auto header = MigrantHeader{};
+            auto payload = std::string{};
+            auto valid = false;
+
+            try {
+                valid = read_all(fd, reinterpret_cast<char*>(&header), sizeof(header), deadline)
+                    && std::memcmp(header.magic, MIGRANT_MESSAGE_MAGIC, sizeof(header.magic)) == 0
+                    && header.payload_size <= max_payload_size;
+
+                if (valid) {
+                    payload.resize(header.payload_size);
+                    valid = read_all(fd, payload.data(), payload.size(), deadline);
+                }
+            } catch (const std::exception&) {
+                valid = false;
+            }
+
+            ::close(fd);
+
+            if (!valid) {
+                std::cerr << "Warning [UnixSocketTransport]: Dropped malformed, oversized or stalled migrant message." << std::endl;
+                continue;
+            }
+
+            try {
+                std::istringstream stream(payload);
+                auto model = Model::load(stream);
+
+                if (!model)
+                    continue;
+
+                std::lock_guard<std::mutex> lock(inbox_mutex);
+                inbox.push_back(MigrantModel{ std::move(*model), header.cost, header.source_island });
+            } catch (const std::exception& exception) {
+                std::cerr << "Warning [UnixSocketTransport]: Dropped migrant message: " << exception.what() << std::endl;
+            }
+        }
+    }
+
+    auto migration_destinations(const IslandParameters& parameters) -> std::vector<std::size_t> {
+        const auto id = parameters.island_id;
+        const auto count = parameters.island_count;
+
+        if (count < 2)
+            return {};
+
+        switch (parameters.topology) {
+            case MigrationTopology::Ring:
+                return { (id + 1) % count };
+
+            case MigrationTopology::FullyConnected: {
+                auto destinations = std::vector<std::size_t>{};
+
+                for (std::size_t island = 0; island < count; ++island)
+                    if (island != id)
+                        destinations.push_back(island);
+
+                return destinations;
+            }
+
+            case MigrationTopology::Random: {
+                const auto offset = static_cast<std::size_t>(rand_int(1, static_cast<int>(count) - 1));
+                return { (id + offset) % count };
+            }
+        }
+
+        return {};
+    }
+
+    auto genetic_algorithm_training_island(
+        std::function<float(Model&)> model_cost_callback,
+        GeneticAlgorithmTrainingParameters parameters,
+        const IslandParameters& island_parameters,
+        std::shared_ptr<MigrationTransport> transport
+    ) -> Model {
+        return genetic_algorithm_training_island(ignore_cutoff(std::move(model_cost_callback)), std::move(parameters), island_parameters, std::move(transport));
+    }
+
+    auto genetic_algorithm_training_island(
+        const EvaluationSpec& spec,
+        GeneticAlgorithmTrainingParameters parameters,
+        const IslandParameters& island_parameters,
+        std::shared_ptr<MigrationTransport> transport
+    ) -> Model {
+        parameters.n_evolution_steps = spec.n_evolution_steps;
+        return genetic_algorithm_training_island(evaluation_cost(spec), std::move(parameters), island_parameters, std::move(transport));
+    }
+
+    auto genetic_algorithm_training_island(
+        CutoffCostCallback model_cost_callback,
+        GeneticAlgorithmTrainingParameters parameters,
+        const IslandParameters& island_parameters,
+        std::shared_ptr<MigrationTransport> transport
+    ) -> Model {
+        if (!transport)
+            transport = std::make_shared<UnixSocketTransport>(island_parameters.island_id, island_parameters.socket_directory, Model::serialized_size(parameters.model_width, parameters.model_height));
+
+        std::cout << "Island " << island_parameters.island_id << " of " << island_parameters.island_count
+                  << ", migrating every " << island_parameters.migration_interval_epochs << " epochs" << std::endl;
+
+        auto previous_callback = parameters.epoch_callback;
+
+        parameters.epoch_callback = [&, previous_callback](Model& best_model, float& best_cost, const long long& epoch) {
+            auto replaced = previous_callback ? previous_callback(best_model, best_cost, epoch) : false;
+
+            if (island_parameters.migration_interval_epochs <= 0 || epoch % island_parameters.migration_interval_epochs != 0)
+                return replaced;
+
+            for (const auto& destination : migration_destinations(island_parameters))
+                transport->send(destination, best_model, best_cost);
+
+            auto migrants = transport->receive();
+
+            // Costs reported by other islands are only a hint, the cost function may be stochastic or differ per island
+            std::sort(migrants.begin(), migrants.end(), [](const auto& a, const auto& b) { return a.cost < b.cost; });
+
+            for (auto& migrant : migrants) {
+                if (migrant.model.width != best_model.width || migrant.model.height != best_model.height)
+                    continue;
+
+                if (migrant.cost >= best_cost)
+                    break;
+
+                const auto local_cost = model_cost_callback(migrant.model, best_cost);
+
+                if (local_cost && *local_cost < best_cost) {
+                    printf("Epoch %lld | Adopted migrant from island %zu | Cost: %.6f -> %.6f\n", epoch, migrant.source_island, best_cost, *local_cost);
+
+                    best_cost = *local_cost;
+                    best_model = std::move(migrant.model);
+                    replaced = true;
+                    break;
+                }
+            }
+
+            return replaced;
+        };
+
+        return genetic_algorithm_training_hyper(model_cost_callback, parameters);
+    }
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+#include "model.h"
+#include "training.h"
+
+namespace m964 {
+    enum class MigrationTopology {
+        Ring,
+        FullyConnected,
+        Random
+    };
+
+    struct MigrantModel {
+        Model model;
+        float cost;
+        std::size_t source_island;
+    };
+
+    class MigrationTransport {
+        public:
+            virtual ~MigrationTransport() = default;
+
+            // Must not block on the receiving island, a missing peer simply drops the migrant
+            virtual auto send(const std::size_t& destination, const Model& model, const float& cost) -> void = 0;
+
+            // Returns every migrant received since the previous call, never blocks
+            virtual auto receive() -> std::vector<MigrantModel> = 0;
+    };
+
+    // Upper bound of a migrant payload when the model size is not known, a 1024x1024 model is about 40 MB
+    constexpr std::size_t DEFAULT_MAX_MIGRANT_PAYLOAD = 64 * 1024 * 1024;
+
+    // A peer that stalls for MIGRANT_IO_TIMEOUT_MS in the middle of a message, or has not delivered it after
+    // MIGRANT_MESSAGE_TIMEOUT_MS, is dropped
+    constexpr int MIGRANT_IO_TIMEOUT_MS = 1000;
+    constexpr int MIGRANT_MESSAGE_TIMEOUT_MS = 10000;
+
+    // Each island listens on <socket_directory>/m964_island_<id>.sock, migrants are collected
+    // by a background thread so a slow peer can never stall the sender's training loop.
+    // Messages with a payload above max_payload_size (see Model::serialized_size) are dropped unread.
+    // send() only queues the migrant, a second thread delivers it and drops it if the peer does not take it
+    // within the timeouts. Only the latest migrant per destination is kept while one is pending.
+    class UnixSocketTransport : public MigrationTransport {
+        private:
+            std::size_t island_id;
+            std::string socket_directory;
+            std::size_t max_payload_size;
+
+            int listen_socket;
+            std::atomic<bool> stopping;
+            std::thread receiver;
+
+            std::mutex inbox_mutex;
+            std::vector<MigrantModel> inbox;
+
+            struct OutgoingMigrant {
+                std::size_t destination;
+                std::string message; // header and serialized model
+            };
+
+            std::thread sender;
+            std::mutex outbox_mutex;
+            std::condition_variable outbox_ready;
+            std::deque<OutgoingMigrant> outbox;
+
+            auto run() -> void;
+            auto run_sender() -> void;
+            auto deliver(const OutgoingMigrant& migrant) const -> bool; // false if a listening peer did not take the whole message
+
+        public:
+            UnixSocketTransport(const std::size_t& island_id, const std::string& socket_directory, const std::size_t& max_payload_size = DEFAULT_MAX_MIGRANT_PAYLOAD);
+            ~UnixSocketTransport() override;
+
+            UnixSocketTransport(const UnixSocketTransport&) = delete;
+            auto operator=(const UnixSocketTransport&) -> UnixSocketTransport& = delete;
+
+            auto send(const std::size_t& destination, const Model& model, const float& cost) -> void override;
+            auto receive() -> std::vector<MigrantModel> override;
+
+            auto socket_path(const std::size_t& island) const -> std::string;
+    };
+
+    struct IslandParameters {
+        std::size_t island_id = 0;
+        std::size_t island_count = 1;
+        int migration_interval_epochs = 50;
+        MigrationTopology topology = MigrationTopology::Ring;
+        std::string socket_directory = "/tmp";
+    };
+
+    auto migration_destinations(const IslandParameters& parameters) -> std::vector<std::size_t>;
+
+    // Runs genetic_algorithm_training_hyper on one island. Every migration interval the island sends its best
+    // model to its neighbours and adopts the best incoming migrant if it also beats the local best on this island's cost.
+    auto genetic_algorithm_training_island(
+        std::function<float(Model&)> model_cost_callback,
+        GeneticAlgorithmTrainingParameters parameters,
+        const IslandParameters& island_parameters,
+        std::shared_ptr<MigrationTransport> transport = nullptr
+    ) -> Model;
+
+    auto genetic_algorithm_training_island(
+        CutoffCostCallback model_cost_callback,
+        GeneticAlgorithmTrainingParameters parameters,
+        const IslandParameters& island_parameters,
+        std::shared_ptr<MigrationTransport> transport = nullptr
+    ) -> Model;
+
+    auto genetic_algorithm_training_island(
+        const EvaluationSpec& spec,
+        GeneticAlgorithmTrainingParameters parameters,
+        const IslandParameters& island_parameters,
+        std::shared_ptr<MigrationTransport> transport = nullptr
+    ) -> Model;
+}
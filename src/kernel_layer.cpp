@@ -1,30 +1,91 @@
 #include "kernel_layer.h"
 
+#include <algorithm>
+#include <stdexcept>
+
 namespace m964 {
-    KernelLayer::KernelLayer(const std::size_t& width, const std::size_t& height) : width(width), height(height) {
-        values.resize(width * height);
+    KernelLayer::KernelLayer(const std::size_t& width, const std::size_t& height) : width(width), height(height), values(width * height), storage(values.data()) {
+
+    }
+
+    KernelLayer::KernelLayer(const std::size_t& width, const std::size_t& height, Kernel* storage) : width(width), height(height), storage(storage) {
+
+    }
+
+    KernelLayer::KernelLayer(const KernelLayer& other) : width(other.width), height(other.height), values(other.storage, other.storage + other.size()), storage(values.data()) {
+
+    }
+
+    KernelLayer::KernelLayer(KernelLayer&& other) noexcept : width(other.width), height(other.height) {
+        if (other.is_view()) {
+            values.assign(other.storage, other.storage + other.size());
+        } else {
+            values = std::move(other.values);
+            other.width = 0;
+            other.height = 0;
+            other.storage = other.values.data();
+        }
+
+        storage = values.data();
+    }
+
+    auto KernelLayer::operator=(const KernelLayer& other) -> KernelLayer& {
+        if (this == &other)
+            return *this;
+
+        if (is_view()) {
+            if (other.width != width || other.height != height)
+                throw std::invalid_argument("KernelLayer::operator=: a view can only be assigned a layer of the same dimensions");
+
+            std::copy_n(other.storage, size(), storage);
+            return *this;
+        }
+
+        width = other.width;
+        height = other.height;
+        values.assign(other.storage, other.storage + other.size());
+        storage = values.data();
+
+        return *this;
+    }
+
+    auto KernelLayer::operator=(KernelLayer&& other) -> KernelLayer& {
+        if (this == &other)
+            return *this;
+
+        if (is_view() || other.is_view())
+            return *this = static_cast<const KernelLayer&>(other);
+
+        width = other.width;
+        height = other.height;
+        values = std::move(other.values);
+        storage = values.data();
+        other.width = 0;
+        other.height = 0;
+        other.storage = other.values.data();
+
+        return *this;
     }
 
     auto KernelLayer::fill(const Kernel& value) -> void  {
-        for (auto& v : values)
-            v = value;
+        std::fill_n(storage, size(), value);
     }
 
     auto KernelLayer::fill(const std::function<Kernel()>& lambda) -> void {
-        for (auto& value : values)
-            value = lambda();
+        for (std::size_t i = 0; i < size(); ++i)
+            storage[i] = lambda();
     }
 
     auto KernelLayer::fill(const std::function<Kernel(const std::size_t&, const std::size_t&)>& lambda) -> void {
         for(std::size_t x = 0; x < width; ++x)
             for(std::size_t y = 0; y < height; ++y)
-                values[x + y*width] = lambda(x, y);
+                storage[x + y*width] = lambda(x, y);
     }
 
     auto KernelLayer::apply(const std::function<void(Kernel&)>& lambda) -> KernelLayer& {
         for(std::size_t x = 0; x < width; ++x)
             for(std::size_t y = 0; y < height; ++y)
-                lambda(values[x + y*width]);
+                lambda(storage[x + y*width]);
 
         return *this;
     }
@@ -37,11 +98,27 @@ namespace m964 {
         return height;
     }
 
+    auto KernelLayer::is_view() const -> bool {
+        return storage != values.data();
+    }
+
+    auto KernelLayer::size() const -> std::size_t {
+        return width * height;
+    }
+
+    auto KernelLayer::data() -> Kernel* {
+        return storage;
+    }
+
+    auto KernelLayer::data() const -> const Kernel* {
+        return storage;
+    }
+
     auto KernelLayer::operator()(const size_t& x, const size_t& y) -> Kernel& {
-        return values[x + y*width];
+        return storage[x + y*width];
     }
 
     auto KernelLayer::operator()(const size_t& x, const size_t& y) const -> const Kernel& {
-        return values[x + y*width];
+        return storage[x + y*width];
     }
 }
\ No newline at end of file
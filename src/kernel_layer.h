@@ -13,10 +13,19 @@ namespace m964 {
             std::size_t height;
 
             std::vector<Kernel> values;
-        
+            Kernel* storage; // values.data(), or the buffer a view refers to
+
         public:
             explicit KernelLayer(const std::size_t& width, const std::size_t& height);
 
+            // Non-owning view, with the same copy and assignment rules as a Layer view
+            KernelLayer(const std::size_t& width, const std::size_t& height, Kernel* storage);
+
+            KernelLayer(const KernelLayer& other);
+            KernelLayer(KernelLayer&& other) noexcept;
+            auto operator=(const KernelLayer& other) -> KernelLayer&;
+            auto operator=(KernelLayer&& other) -> KernelLayer&;
+
             auto fill(const Kernel& value) -> void;
             auto fill(const std::function<Kernel()>& lambda) -> void;
             auto fill(const std::function<Kernel(const std::size_t&, const std::size_t&)>& lambda) -> void;
@@ -25,6 +34,11 @@ namespace m964 {
 
             [[nodiscard]] auto get_width() const -> std::size_t;
             [[nodiscard]] auto get_height() const -> std::size_t;
+            [[nodiscard]] auto is_view() const -> bool;
+
+            [[nodiscard]] auto size() const -> std::size_t;
+            [[nodiscard]] auto data() -> Kernel*;
+            [[nodiscard]] auto data() const -> const Kernel*;
 
             auto operator()(const size_t& x, const size_t& y) -> Kernel&;
             auto operator()(const size_t& x, const size_t& y) const -> const Kernel&;
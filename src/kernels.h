@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace m964 {
+    enum class CpuVariant {
+        Generic,
+        AVX2,
+        AVX512
+    };
+
+    // Raw pointer inner loops of the step, loss and mutation code, compiled once per CpuVariant.
+    // All variants give bit-identical results: the per-element operation order is fixed and the
+    // variant translation units are built without FMA contraction.
+    struct KernelTable {
+        CpuVariant variant;
+        const char* name;
+
+        // Interior cells (1..width-2, 1..height-2) of calculate_state, weights holds the 9 values of every cell's Kernel
+        void (*step_interior)(float* next, const float* state, const float* weights, std::size_t width, std::size_t height);
+        // The same for the interior cells in columns [x_begin, x_end) and rows [y_begin, y_end) only
+        void (*step_interior_rect)(float* next, const float* state, const float* weights, std::size_t width, std::size_t x_begin, std::size_t x_end, std::size_t y_begin, std::size_t y_end);
+
+        // One step of KERNEL_LANES (8) models of the same size, interleaved cell by cell: state[cell * 8 + lane],
+        // weights[(cell * 9 + k) * 8 + lane], biases[cell * 8 + lane]. Matches calculate_state followed by bias_relu_rows,
+        // or by relu when biases is null, for width and height >= 3.
+        void (*step_lanes)(float* next, const float* state, const float* weights, const float* biases, std::size_t width, std::size_t height);
+
+        // Rows [first_row, last_row) of a width wide layer: adds the bias for x >= 1 and y >= 1, then clamps negatives to 0
+        void (*bias_relu_rows)(float* values, const float* biases, std::size_t width, std::size_t first_row, std::size_t last_row);
+        void (*relu)(float* values, std::size_t count);
+
+        // lanes[i % 8] += (mask[i] *) difference(state[i], target[i]), count is a multiple of 8, mask may be null
+        void (*squared_error_lanes)(float* lanes, const float* state, const float* target, const float* mask, std::size_t count);
+        void (*absolute_error_lanes)(float* lanes, const float* state, const float* target, const float* mask, std::size_t count);
+        void (*sum_lanes)(float* lanes, const float* values, std::size_t count);
+
+        // values[i] += noise[i] * scale and values[i] += noise[i]
+        void (*add_scaled)(float* values, const float* noise, float scale, std::size_t count);
+        void (*add)(float* values, const float* noise, std::size_t count);
+
+        // values[i] = bitmap[i] != 0 ? on_value : 0
+        void (*binarize_u8)(float* values, const std::uint8_t* bitmap, float on_value, std::size_t count);
+        void (*binarize_i32)(float* values, const std::int32_t* bitmap, float on_value, std::size_t count);
+    };
+
+    auto generic_kernels() -> KernelTable;
+#if defined(M964_KERNEL_VARIANTS)
+    auto avx2_kernels() -> KernelTable;
+    auto avx512_kernels() -> KernelTable;
+#endif
+
+    auto cpu_variant_name(const CpuVariant& variant) -> const char*;
+
+    // Widest variant that is compiled in and supported by this CPU
+    auto supported_cpu_variant() -> CpuVariant;
+
+    // Selected on first use. M964_CPU_VARIANT=generic|avx2|avx512 forces a variant, if the CPU supports it.
+    auto active_kernels() -> const KernelTable&;
+}
@@ -0,0 +1,12 @@
+// Compiled with -mavx2 (see CMakeLists.txt), only reached through active_kernels() on CPUs that support it
+#if defined(M964_KERNEL_VARIANTS)
+
+#include "kernels_impl.h"
+
+namespace m964 {
+    auto avx2_kernels() -> KernelTable {
+        return make_kernel_table(CpuVariant::AVX2, "avx2");
+    }
+}
+
+#endif
@@ -0,0 +1,12 @@
+// Compiled with -mavx512f (see CMakeLists.txt), only reached through active_kernels() on CPUs that support it
+#if defined(M964_KERNEL_VARIANTS)
+
+#include "kernels_impl.h"
+
+namespace m964 {
+    auto avx512_kernels() -> KernelTable {
+        return make_kernel_table(CpuVariant::AVX512, "avx512");
+    }
+}
+
+#endif
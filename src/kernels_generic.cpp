@@ -0,0 +1,7 @@
+#include "kernels_impl.h"
+
+namespace m964 {
+    auto generic_kernels() -> KernelTable {
+        return make_kernel_table(CpuVariant::Generic, "generic");
+    }
+}
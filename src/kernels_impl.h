@@ -0,0 +1,250 @@
+#pragma once
+
+// Kernel bodies shared by kernels_generic.cpp, kernels_avx2.cpp and kernels_avx512.cpp. Everything lives in an
+// anonymous namespace so every variant translation unit keeps its own copy: an out-of-line AVX-512 instance
+// must never be merged with the generic one by the linker.
+
+#include <cstddef>
+#include <cstdint>
+
+#include "kernels.h"
+
+namespace m964 {
+    namespace {
+        constexpr std::size_t KERNEL_LANES = 8;
+
+        auto step_interior_rect(float* __restrict next, const float* __restrict state, const float* __restrict weights, std::size_t width, std::size_t x_begin, std::size_t x_end, std::size_t y_begin, std::size_t y_end) -> void {
+            for (std::size_t y = y_begin; y < y_end; ++y) {
+                const auto* above = state + (y - 1) * width;
+                const auto* row = state + y * width;
+                const auto* below = state + (y + 1) * width;
+                const auto* kernels = weights + y * width * 9;
+                auto* out = next + y * width;
+
+                // Same summation order as the scalar interior of calculate_state
+                for (std::size_t x = x_begin; x < x_end; ++x) {
+                    const auto* kernel = kernels + x * 9;
+
+                    auto value = row[x] * kernel[4];
+                    value += below[x] * kernel[7];
+                    value += above[x] * kernel[1];
+                    value += row[x + 1] * kernel[5];
+                    value += row[x - 1] * kernel[3];
+                    value += below[x + 1] * kernel[8];
+                    value += above[x - 1] * kernel[0];
+                    value += above[x + 1] * kernel[2];
+                    value += below[x - 1] * kernel[6];
+                    out[x] = value;
+                }
+            }
+        }
+
+        auto step_interior(float* __restrict next, const float* __restrict state, const float* __restrict weights, std::size_t width, std::size_t height) -> void {
+            if (width < 3 || height < 3)
+                return;
+
+            step_interior_rect(next, state, weights, width, 1, width - 1, 1, height - 1);
+        }
+
+        // Neighbour (dx, dy) of a cell and the index of its weight in the cell's kernel
+        struct Tap {
+            int dx;
+            int dy;
+            std::size_t weight;
+        };
+
+        // Border cells drop the missing neighbours and keep the summation order of border_value in model.cpp
+        constexpr Tap TOP_LEFT_TAPS[] = { { 0, 0, 4 }, { 0, 1, 7 }, { 1, 0, 5 }, { 1, 1, 8 } };
+        constexpr Tap TOP_RIGHT_TAPS[] = { { 0, 0, 4 }, { 0, 1, 7 }, { -1, 0, 3 }, { -1, 1, 6 } };
+        constexpr Tap TOP_TAPS[] = { { 0, 0, 4 }, { 0, 1, 7 }, { 1, 0, 5 }, { -1, 0, 3 }, { 1, 1, 8 }, { -1, 1, 6 } };
+        constexpr Tap BOTTOM_LEFT_TAPS[] = { { 0, 0, 4 }, { 0, -1, 1 }, { 1, 0, 5 }, { 1, -1, 2 } };
+        constexpr Tap BOTTOM_RIGHT_TAPS[] = { { 0, 0, 4 }, { 0, -1, 1 }, { -1, 0, 3 }, { -1, -1, 0 } };
+        constexpr Tap BOTTOM_TAPS[] = { { 0, 0, 4 }, { 0, -1, 1 }, { 1, 0, 5 }, { -1, 0, 3 }, { 1, -1, 2 }, { -1, -1, 0 } };
+        constexpr Tap LEFT_TAPS[] = { { 0, 0, 4 }, { 0, 1, 7 }, { 0, -1, 1 }, { 1, 0, 5 }, { 1, 1, 8 }, { 1, -1, 2 } };
+        constexpr Tap RIGHT_TAPS[] = { { 0, 0, 4 }, { 0, 1, 7 }, { 0, -1, 1 }, { -1, 0, 3 }, { -1, 1, 6 }, { -1, -1, 0 } };
+
+        // One cell of KERNEL_LANES interleaved models: the kernel sum, the bias (if any) and the ReLU of simulate_step_with_biases
+        template<std::size_t N>
+        auto cell_lanes(float* __restrict next, const float* __restrict state, const float* __restrict weights, const float* __restrict biases, std::size_t width, std::size_t x, std::size_t y, const Tap (&taps)[N]) -> void {
+            const auto cell = x + y * width;
+            const auto* kernel = weights + cell * 9 * KERNEL_LANES;
+            auto* out = next + cell * KERNEL_LANES;
+
+            const auto neighbour = [&](const Tap& tap) {
+                const auto offset = static_cast<std::ptrdiff_t>(cell) + tap.dx + tap.dy * static_cast<std::ptrdiff_t>(width);
+                return state + offset * static_cast<std::ptrdiff_t>(KERNEL_LANES);
+            };
+
+            for (std::size_t lane = 0; lane < KERNEL_LANES; ++lane) {
+                auto value = neighbour(taps[0])[lane] * kernel[taps[0].weight * KERNEL_LANES + lane];
+
+                for (std::size_t i = 1; i < N; ++i)
+                    value += neighbour(taps[i])[lane] * kernel[taps[i].weight * KERNEL_LANES + lane];
+
+                if (biases != nullptr && x >= 1 && y >= 1)
+                    value += biases[cell * KERNEL_LANES + lane];
+
+                out[lane] = value < 0.0f ? 0.0f : value;
+            }
+        }
+
+        auto step_lanes(float* __restrict next, const float* __restrict state, const float* __restrict weights, const float* __restrict biases, std::size_t width, std::size_t height) -> void {
+            if (width < 3 || height < 3)
+                return;
+
+            const auto width_m = width - 1;
+            const auto height_m = height - 1;
+
+            cell_lanes(next, state, weights, biases, width, 0, 0, TOP_LEFT_TAPS);
+            cell_lanes(next, state, weights, biases, width, width_m, 0, TOP_RIGHT_TAPS);
+            cell_lanes(next, state, weights, biases, width, 0, height_m, BOTTOM_LEFT_TAPS);
+            cell_lanes(next, state, weights, biases, width, width_m, height_m, BOTTOM_RIGHT_TAPS);
+
+            for (std::size_t x = 1; x < width_m; ++x) {
+                cell_lanes(next, state, weights, biases, width, x, 0, TOP_TAPS);
+                cell_lanes(next, state, weights, biases, width, x, height_m, BOTTOM_TAPS);
+            }
+
+            for (std::size_t y = 1; y < height_m; ++y) {
+                cell_lanes(next, state, weights, biases, width, 0, y, LEFT_TAPS);
+                cell_lanes(next, state, weights, biases, width, width_m, y, RIGHT_TAPS);
+
+                // Interior, the summation order of step_interior_rect
+                for (std::size_t x = 1; x < width_m; ++x) {
+                    const auto cell = x + y * width;
+                    const auto* kernel = weights + cell * 9 * KERNEL_LANES;
+                    const auto* row = state + cell * KERNEL_LANES;
+                    const auto* above = row - width * KERNEL_LANES;
+                    const auto* below = row + width * KERNEL_LANES;
+                    auto* out = next + cell * KERNEL_LANES;
+
+                    for (std::size_t lane = 0; lane < KERNEL_LANES; ++lane) {
+                        auto value = row[lane] * kernel[4 * KERNEL_LANES + lane];
+                        value += below[lane] * kernel[7 * KERNEL_LANES + lane];
+                        value += above[lane] * kernel[1 * KERNEL_LANES + lane];
+                        value += row[KERNEL_LANES + lane] * kernel[5 * KERNEL_LANES + lane];
+                        value += (row - KERNEL_LANES)[lane] * kernel[3 * KERNEL_LANES + lane];
+                        value += below[KERNEL_LANES + lane] * kernel[8 * KERNEL_LANES + lane];
+                        value += (above - KERNEL_LANES)[lane] * kernel[0 * KERNEL_LANES + lane];
+                        value += above[KERNEL_LANES + lane] * kernel[2 * KERNEL_LANES + lane];
+                        value += (below - KERNEL_LANES)[lane] * kernel[6 * KERNEL_LANES + lane];
+
+                        if (biases != nullptr)
+                            value += biases[cell * KERNEL_LANES + lane];
+
+                        out[lane] = value < 0.0f ? 0.0f : value;
+                    }
+                }
+            }
+        }
+
+        auto relu(float* __restrict values, std::size_t count) -> void {
+            for (std::size_t i = 0; i < count; ++i)
+                values[i] = values[i] < 0.0f ? 0.0f : values[i];
+        }
+
+        auto bias_relu_rows(float* __restrict values, const float* __restrict biases, std::size_t width, std::size_t first_row, std::size_t last_row) -> void {
+            for (std::size_t y = first_row; y < last_row; ++y) {
+                auto* row = values + y * width;
+
+                if (y >= 1) {
+                    const auto* bias_row = biases + y * width;
+                    for (std::size_t x = 1; x < width; ++x)
+                        row[x] += bias_row[x];
+                }
+
+                relu(row, width);
+            }
+        }
+
+        template<typename Difference>
+        auto difference_lanes(float* __restrict lanes, const float* __restrict state, const float* __restrict target, const float* __restrict mask, std::size_t count, const Difference& difference) -> void {
+            float accumulator[KERNEL_LANES];
+            for (std::size_t lane = 0; lane < KERNEL_LANES; ++lane)
+                accumulator[lane] = lanes[lane];
+
+            if (mask == nullptr) {
+                for (std::size_t i = 0; i < count; i += KERNEL_LANES)
+                    for (std::size_t lane = 0; lane < KERNEL_LANES; ++lane)
+                        accumulator[lane] += difference(state[i + lane], target[i + lane]);
+            } else {
+                for (std::size_t i = 0; i < count; i += KERNEL_LANES)
+                    for (std::size_t lane = 0; lane < KERNEL_LANES; ++lane)
+                        accumulator[lane] += mask[i + lane] * difference(state[i + lane], target[i + lane]);
+            }
+
+            for (std::size_t lane = 0; lane < KERNEL_LANES; ++lane)
+                lanes[lane] = accumulator[lane];
+        }
+
+        auto squared_error_lanes(float* lanes, const float* state, const float* target, const float* mask, std::size_t count) -> void {
+            difference_lanes(lanes, state, target, mask, count, [](const float a, const float b) {
+                const auto difference = a - b;
+                return difference * difference;
+            });
+        }
+
+        auto absolute_error_lanes(float* lanes, const float* state, const float* target, const float* mask, std::size_t count) -> void {
+            difference_lanes(lanes, state, target, mask, count, [](const float a, const float b) {
+                const auto difference = a - b;
+                return difference > 0.0f ? difference : -difference; // std::fabs without pulling in <cmath>
+            });
+        }
+
+        auto sum_lanes(float* __restrict lanes, const float* __restrict values, std::size_t count) -> void {
+            float accumulator[KERNEL_LANES];
+            for (std::size_t lane = 0; lane < KERNEL_LANES; ++lane)
+                accumulator[lane] = lanes[lane];
+
+            for (std::size_t i = 0; i < count; i += KERNEL_LANES)
+                for (std::size_t lane = 0; lane < KERNEL_LANES; ++lane)
+                    accumulator[lane] += values[i + lane];
+
+            for (std::size_t lane = 0; lane < KERNEL_LANES; ++lane)
+                lanes[lane] = accumulator[lane];
+        }
+
+        auto add_scaled(float* __restrict values, const float* __restrict noise, float scale, std::size_t count) -> void {
+            for (std::size_t i = 0; i < count; ++i)
+                values[i] += noise[i] * scale;
+        }
+
+        auto add(float* __restrict values, const float* __restrict noise, std::size_t count) -> void {
+            for (std::size_t i = 0; i < count; ++i)
+                values[i] += noise[i];
+        }
+
+        template<typename Pixel>
+        auto binarize(float* __restrict values, const Pixel* __restrict bitmap, float on_value, std::size_t count) -> void {
+            for (std::size_t i = 0; i < count; ++i)
+                values[i] = bitmap[i] != 0 ? on_value : 0.0f;
+        }
+
+        auto binarize_u8(float* values, const std::uint8_t* bitmap, float on_value, std::size_t count) -> void {
+            binarize(values, bitmap, on_value, count);
+        }
+
+        auto binarize_i32(float* values, const std::int32_t* bitmap, float on_value, std::size_t count) -> void {
+            binarize(values, bitmap, on_value, count);
+        }
+
+        auto make_kernel_table(const CpuVariant& variant, const char* name) -> KernelTable {
+            return KernelTable {
+                .variant = variant,
+                .name = name,
+                .step_interior = step_interior,
+                .step_interior_rect = step_interior_rect,
+                .step_lanes = step_lanes,
+                .bias_relu_rows = bias_relu_rows,
+                .relu = relu,
+                .squared_error_lanes = squared_error_lanes,
+                .absolute_error_lanes = absolute_error_lanes,
+                .sum_lanes = sum_lanes,
+                .add_scaled = add_scaled,
+                .add = add,
+                .binarize_u8 = binarize_u8,
+                .binarize_i32 = binarize_i32
+            };
+        }
+    }
+}
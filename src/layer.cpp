@@ -1,14 +1,76 @@
 #include "layer.h"
 
+#include <algorithm>
+#include <stdexcept>
+
 namespace m964 {
-    Layer::Layer(const std::size_t& width, const std::size_t& height) : width(width), height(height) {
-        values.resize(width * height);
+    Layer::Layer(const std::size_t& width, const std::size_t& height) : width(width), height(height), values(width * height), storage(values.data()) {
+
+    }
+
+    Layer::Layer(const std::size_t& width, const std::size_t& height, float* storage) : width(width), height(height), storage(storage) {
+
+    }
+
+    Layer::Layer(const Layer& other) : width(other.width), height(other.height), values(other.storage, other.storage + other.size()), storage(values.data()) {
+
+    }
+
+    Layer::Layer(Layer&& other) noexcept : width(other.width), height(other.height) {
+        if (other.is_view()) {
+            values.assign(other.storage, other.storage + other.size());
+        } else {
+            values = std::move(other.values);
+            other.width = 0;
+            other.height = 0;
+            other.storage = other.values.data();
+        }
+
+        storage = values.data();
+    }
+
+    auto Layer::operator=(const Layer& other) -> Layer& {
+        if (this == &other)
+            return *this;
+
+        if (is_view()) {
+            if (other.width != width || other.height != height)
+                throw std::invalid_argument("Layer::operator=: a view can only be assigned a layer of the same dimensions");
+
+            std::copy_n(other.storage, size(), storage);
+            return *this;
+        }
+
+        width = other.width;
+        height = other.height;
+        values.assign(other.storage, other.storage + other.size());
+        storage = values.data();
+
+        return *this;
+    }
+
+    auto Layer::operator=(Layer&& other) -> Layer& {
+        if (this == &other)
+            return *this;
+
+        if (is_view() || other.is_view())
+            return *this = static_cast<const Layer&>(other);
+
+        width = other.width;
+        height = other.height;
+        values = std::move(other.values);
+        storage = values.data();
+        other.width = 0;
+        other.height = 0;
+        other.storage = other.values.data();
+
+        return *this;
     }
 
     auto Layer::fill(const float& value) -> Layer& {
         for(std::size_t x = 0; x < width; ++x)
             for(std::size_t y = 0; y < height; ++y)
-                values[x + y*width] = value;
+                storage[x + y*width] = value;
 
         return *this;
     }
@@ -16,7 +78,7 @@ namespace m964 {
     auto Layer::fill(const std::function<float()>& lambda) -> Layer& {
         for(std::size_t x = 0; x < width; ++x)
             for(std::size_t y = 0; y < height; ++y)
-                values[x + y*width] = lambda();
+                storage[x + y*width] = lambda();
 
         return *this;
     }
@@ -24,7 +86,7 @@ namespace m964 {
     auto Layer::fill(const std::function<float(const std::size_t&, const std::size_t&)>& lambda) -> Layer& {
         for(std::size_t x = 0; x < width; ++x)
             for(std::size_t y = 0; y < height; ++y)
-                values[x + y*width] = lambda(x, y);
+                storage[x + y*width] = lambda(x, y);
 
         return *this;
     }
@@ -32,7 +94,7 @@ namespace m964 {
     auto Layer::apply(const std::function<void(float&)>& lambda) -> Layer& {
         for(std::size_t x = 0; x < width; ++x)
             for(std::size_t y = 0; y < height; ++y)
-                lambda(values[x + y*width]);
+                lambda(storage[x + y*width]);
 
         return *this;
     }
@@ -45,11 +107,35 @@ namespace m964 {
         return height;
     }
 
+    auto Layer::is_view() const -> bool {
+        return storage != values.data();
+    }
+
+    auto Layer::size() const -> std::size_t {
+        return width * height;
+    }
+
+    auto Layer::data() -> float* {
+        return storage;
+    }
+
+    auto Layer::data() const -> const float* {
+        return storage;
+    }
+
+    auto Layer::row(const std::size_t& y) -> std::span<float> {
+        return std::span<float>(storage + y*width, width);
+    }
+
+    auto Layer::row(const std::size_t& y) const -> std::span<const float> {
+        return std::span<const float>(storage + y*width, width);
+    }
+
     auto Layer::operator()(const size_t& x, const size_t& y) -> float& {
-        return values[x + y*width];
+        return storage[x + y*width];
     }
 
     auto Layer::operator()(const size_t& x, const size_t& y) const -> const float& {
-        return values[x + y*width];
+        return storage[x + y*width];
     }
 }
\ No newline at end of file
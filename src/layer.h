@@ -2,6 +2,7 @@
 
 #include <cstddef>
 #include <vector>
+#include <span>
 #include <functional>
 
 namespace m964 {
@@ -11,10 +12,20 @@ namespace m964 {
             std::size_t height;
 
             std::vector<float> values;
+            float* storage; // values.data(), or the buffer a view refers to
 
         public:
             Layer(const std::size_t& width, const std::size_t& height);
 
+            // Non-owning view of width * height floats that outlive it, e.g. Model's parameter buffer. Copies of a view own
+            // their values, assigning to a view copies into its storage and needs equal dimensions.
+            Layer(const std::size_t& width, const std::size_t& height, float* storage);
+
+            Layer(const Layer& other);
+            Layer(Layer&& other) noexcept;
+            auto operator=(const Layer& other) -> Layer&;
+            auto operator=(Layer&& other) -> Layer&;
+
             auto fill(const float& value) -> Layer&;
             auto fill(const std::function<float()>& lambda) -> Layer&;
             auto fill(const std::function<float(const std::size_t&, const std::size_t&)>& lambda) -> Layer&;
@@ -23,6 +34,15 @@ namespace m964 {
 
             auto get_width() const -> std::size_t;
             auto get_height() const -> std::size_t;
+            auto is_view() const -> bool;
+
+            auto size() const -> std::size_t;
+            auto data() -> float*;
+            auto data() const -> const float*;
+
+            // Row y of the row-major storage, environments can write observations straight into it
+            auto row(const std::size_t& y) -> std::span<float>;
+            auto row(const std::size_t& y) const -> std::span<const float>;
 
             auto operator()(const size_t& x, const size_t& y) -> float&;
             auto operator()(const size_t& x, const size_t& y) const -> const float&;
@@ -0,0 +1,83 @@
+#include "light_cone.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "perf_counters.h"
+#include "kernels.h"
+
+namespace m964 {
+    auto probe_region(const std::vector<ProbeCell>& probes) -> CellRegion {
+        if (probes.empty())
+            throw std::invalid_argument("probe_region: no probe cells");
+
+        auto region = CellRegion { probes[0].x, probes[0].x + 1, probes[0].y, probes[0].y + 1 };
+
+        for (const auto& probe : probes) {
+            region.x_begin = std::min(region.x_begin, probe.x);
+            region.x_end = std::max(region.x_end, probe.x + 1);
+            region.y_begin = std::min(region.y_begin, probe.y);
+            region.y_end = std::max(region.y_end, probe.y + 1);
+        }
+
+        return region;
+    }
+
+    auto grow_region(const CellRegion& region, const std::size_t& margin, const std::size_t& width, const std::size_t& height) -> CellRegion {
+        return CellRegion {
+            region.x_begin - std::min(region.x_begin, margin),
+            std::min(width, region.x_end + std::min(width, margin)),
+            region.y_begin - std::min(region.y_begin, margin),
+            std::min(height, region.y_end + std::min(height, margin))
+        };
+    }
+
+    auto light_cone(const std::size_t& width, const std::size_t& height, const CellRegion& readout, const std::size_t& step, const std::size_t& n_steps) -> CellRegion {
+        return grow_region(readout, n_steps - 1 - step, width, height);
+    }
+
+    auto step_region(Layer& new_state, const Layer& state, const Model& model, const CellRegion& region, const bool& biases) -> void {
+        calculate_state_region(new_state, state, model.weights, region.x_begin, region.x_end, region.y_begin, region.y_end);
+
+        const auto& kernels = active_kernels();
+        const auto width = model.width;
+        const auto bias_x_begin = std::max<std::size_t>(region.x_begin, 1);
+
+        // Same per cell operations as bias_relu_rows / relu over the whole state
+        for (auto y = region.y_begin; y < region.y_end; ++y) {
+            auto* row = new_state.data() + y * width;
+
+            if (biases && y >= 1) {
+                const auto* bias_row = model.bias_layer.data() + y * width;
+                for (auto x = bias_x_begin; x < region.x_end; ++x)
+                    row[x] += bias_row[x];
+            }
+
+            kernels.relu(row + region.x_begin, region.x_end - region.x_begin);
+        }
+    }
+
+    auto simulate_step_region(Model& model, const CellRegion& region, const bool& biases) -> void {
+        if (region.x_begin == 0 && region.x_end == model.width && region.y_begin == 0 && region.y_end == model.height) {
+            if (biases)
+                model.simulate_step_with_biases();
+            else
+                model.simulate_step();
+            return;
+        }
+
+        const auto perf_scope = PerfScope(PerfRegion::Step);
+
+        step_region(model.get_new_state(), model.get_old_state(), model, region, biases);
+
+        std::swap(model.old_state, model.new_state);
+    }
+
+    auto simulate_steps_for_readout(Model& model, const CellRegion& readout, const std::size_t& n_steps, const bool& biases) -> void {
+        if (readout.x_begin >= readout.x_end || readout.y_begin >= readout.y_end || readout.x_end > model.width || readout.y_end > model.height)
+            throw std::invalid_argument("simulate_steps_for_readout: readout region is empty or outside of the model");
+
+        for (std::size_t t = 0; t < n_steps; ++t)
+            simulate_step_region(model, light_cone(model.width, model.height, readout, t, n_steps), biases);
+    }
+}
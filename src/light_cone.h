@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "model.h"
+#include "loss.h"
+
+namespace m964 {
+    // Cells in columns [x_begin, x_end) and rows [y_begin, y_end)
+    struct CellRegion {
+        std::size_t x_begin;
+        std::size_t x_end;
+        std::size_t y_begin;
+        std::size_t y_end;
+    };
+
+    // Bounding box of the probe cells
+    auto probe_region(const std::vector<ProbeCell>& probes) -> CellRegion;
+
+    // The region grown by margin cells in every direction, clipped to the grid
+    auto grow_region(const CellRegion& region, const std::size_t& margin, const std::size_t& width, const std::size_t& height) -> CellRegion;
+
+    // A cell only reads its 3x3 neighbourhood, so a cell d cells away from the readout (Chebyshev distance) can only affect it
+    // d steps later. Step t (0 based) of n_steps therefore only has to compute the readout grown by n_steps - 1 - t cells.
+    auto light_cone(const std::size_t& width, const std::size_t& height, const CellRegion& readout, const std::size_t& step, const std::size_t& n_steps) -> CellRegion;
+
+    // One step of the model from state into new_state, computing only the region
+    auto step_region(Layer& new_state, const Layer& state, const Model& model, const CellRegion& region, const bool& biases = true) -> void;
+
+    // Model::simulate_step or Model::simulate_step_with_biases computing only the region of the new state
+    auto simulate_step_region(Model& model, const CellRegion& region, const bool& biases = true) -> void;
+
+    // n_steps steps, each restricted to the light cone of the readout. Afterwards the readout cells of get_old_state() are
+    // exactly the ones of a full rollout while the other cells of both states are stale, so reset or overwrite them before reuse.
+    auto simulate_steps_for_readout(Model& model, const CellRegion& readout, const std::size_t& n_steps, const bool& biases = true) -> void;
+}
@@ -0,0 +1,273 @@
+#include "live_feed.h"
+
+#include <atomic>
+#include <cstring>
+#include <new>
+#include <iostream>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace m964 {
+    namespace {
+        constexpr std::uint32_t LIVE_FEED_VERSION = 1;
+        constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+        struct LiveFeedHeader {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t slot_count;
+            std::uint64_t width;
+            std::uint64_t height;
+            std::atomic<std::uint64_t> frame_count;
+        };
+
+        static_assert(sizeof(LiveFeedHeader) <= CACHE_LINE_SIZE);
+        static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "Shared memory seqlocks need lock-free 64 bit atomics");
+
+        auto shared_memory_path(const std::string& name) -> std::string {
+            return "/m964_" + name;
+        }
+
+        // Every slot starts on its own cache line: the seqlock word, then the frame values
+        auto slot_stride(const std::size_t& width, const std::size_t& height) -> std::size_t {
+            const auto values_size = width * height * sizeof(float);
+            return CACHE_LINE_SIZE + (values_size + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+        }
+
+        auto feed_size(const std::size_t& width, const std::size_t& height, const std::size_t& slot_count) -> std::size_t {
+            return CACHE_LINE_SIZE + slot_count * slot_stride(width, height);
+        }
+
+        auto slot_sequence(const void* mapping, const std::size_t& stride, const std::size_t& slot) -> std::atomic<std::uint64_t>* {
+            auto* base = static_cast<char*>(const_cast<void*>(mapping)) + CACHE_LINE_SIZE + slot * stride;
+            return reinterpret_cast<std::atomic<std::uint64_t>*>(base);
+        }
+
+        auto slot_values(const void* mapping, const std::size_t& stride, const std::size_t& slot) -> float* {
+            auto* base = static_cast<char*>(const_cast<void*>(mapping)) + CACHE_LINE_SIZE + slot * stride;
+            return reinterpret_cast<float*>(base + CACHE_LINE_SIZE);
+        }
+
+        auto header_of(const void* mapping) -> LiveFeedHeader* {
+            return static_cast<LiveFeedHeader*>(const_cast<void*>(mapping));
+        }
+    }
+
+    LiveFeedPublisher::LiveFeedPublisher(
+        const std::string& name,
+        const std::size_t& width,
+        const std::size_t& height,
+        const std::size_t& slot_count
+    ) : shared_memory_name(shared_memory_path(name)),
+        width(width),
+        height(height),
+        slot_count(slot_count > 0 ? slot_count : 1),
+        mapping(nullptr),
+        mapping_size(0),
+        published_frames(0)
+    {
+        const auto fd = ::shm_open(shared_memory_name.c_str(), O_CREAT | O_RDWR, 0600);
+        if (fd < 0) {
+            std::cerr << "Error [LiveFeedPublisher]: Could not create shared memory " << shared_memory_name << std::endl;
+            return;
+        }
+
+        const auto size = feed_size(width, height, this->slot_count);
+        if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            std::cerr << "Error [LiveFeedPublisher]: Could not resize shared memory " << shared_memory_name << std::endl;
+            ::close(fd);
+            return;
+        }
+
+        auto* mapped = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+
+        if (mapped == MAP_FAILED) {
+            std::cerr << "Error [LiveFeedPublisher]: Could not map shared memory " << shared_memory_name << std::endl;
+            return;
+        }
+
+        mapping = mapped;
+        mapping_size = size;
+
+        // A previous run may have left a feed behind, readers only accept it again once the magic is back
+        auto* header = header_of(mapping);
+        std::memset(header->magic, 0, sizeof(header->magic));
+        std::atomic_thread_fence(std::memory_order_release);
+
+        header->version = LIVE_FEED_VERSION;
+        header->slot_count = static_cast<std::uint32_t>(this->slot_count);
+        header->width = width;
+        header->height = height;
+        new (&header->frame_count) std::atomic<std::uint64_t>(0);
+
+        const auto stride = slot_stride(width, height);
+        for (std::size_t slot = 0; slot < this->slot_count; ++slot)
+            new (slot_sequence(mapping, stride, slot)) std::atomic<std::uint64_t>(0);
+
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(header->magic, LIVE_FEED_MAGIC, sizeof(LIVE_FEED_MAGIC));
+    }
+
+    LiveFeedPublisher::~LiveFeedPublisher() {
+        if (mapping == nullptr)
+            return;
+
+        ::munmap(mapping, mapping_size);
+        ::shm_unlink(shared_memory_name.c_str());
+    }
+
+    auto LiveFeedPublisher::is_open() const -> bool {
+        return mapping != nullptr;
+    }
+
+    auto LiveFeedPublisher::get_published_frames() const -> std::uint64_t {
+        return published_frames;
+    }
+
+    auto LiveFeedPublisher::publish(const Layer& state) -> void {
+        if (mapping == nullptr)
+            return;
+
+        if (state.get_width() != width || state.get_height() != height) {
+            std::cerr << "Error [LiveFeedPublisher::publish]: State dimensions do not match the feed." << std::endl;
+            return;
+        }
+
+        const auto frame = published_frames;
+        const auto stride = slot_stride(width, height);
+        const auto slot = static_cast<std::size_t>(frame % slot_count);
+
+        auto* sequence = slot_sequence(mapping, stride, slot);
+
+        // Odd while the slot is being written, 2 * frame + 2 once frame is complete
+        sequence->store(2 * frame + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        std::memcpy(slot_values(mapping, stride, slot), state.data(), state.size() * sizeof(float));
+
+        sequence->store(2 * frame + 2, std::memory_order_release);
+        header_of(mapping)->frame_count.store(frame + 1, std::memory_order_release);
+
+        ++published_frames;
+    }
+
+    LiveFeedReader::LiveFeedReader(
+        const std::string& name
+    ) : width(0),
+        height(0),
+        slot_count(0),
+        mapping(nullptr),
+        mapping_size(0)
+    {
+        const auto path = shared_memory_path(name);
+
+        const auto fd = ::shm_open(path.c_str(), O_RDONLY, 0);
+        if (fd < 0) {
+            std::cerr << "Error [LiveFeedReader]: No live feed " << path << std::endl;
+            return;
+        }
+
+        struct stat info{};
+        if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < CACHE_LINE_SIZE) {
+            std::cerr << "Error [LiveFeedReader]: " << path << " is not initialized yet." << std::endl;
+            ::close(fd);
+            return;
+        }
+
+        const auto size = static_cast<std::size_t>(info.st_size);
+        auto* mapped = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+
+        if (mapped == MAP_FAILED) {
+            std::cerr << "Error [LiveFeedReader]: Could not map " << path << std::endl;
+            return;
+        }
+
+        const auto* header = header_of(mapped);
+        const auto valid = std::memcmp(header->magic, LIVE_FEED_MAGIC, sizeof(LIVE_FEED_MAGIC)) == 0
+            && header->version == LIVE_FEED_VERSION
+            && header->slot_count > 0
+            && feed_size(header->width, header->height, header->slot_count) == size;
+
+        if (!valid) {
+            std::cerr << "Error [LiveFeedReader]: " << path << " is not a live feed." << std::endl;
+            ::munmap(mapped, size);
+            return;
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        mapping = mapped;
+        mapping_size = size;
+        width = header->width;
+        height = header->height;
+        slot_count = header->slot_count;
+    }
+
+    LiveFeedReader::~LiveFeedReader() {
+        if (mapping != nullptr)
+            ::munmap(const_cast<void*>(mapping), mapping_size);
+    }
+
+    auto LiveFeedReader::is_open() const -> bool {
+        return mapping != nullptr;
+    }
+
+    auto LiveFeedReader::get_width() const -> std::size_t {
+        return width;
+    }
+
+    auto LiveFeedReader::get_height() const -> std::size_t {
+        return height;
+    }
+
+    auto LiveFeedReader::frame_count() const -> std::uint64_t {
+        if (mapping == nullptr)
+            return 0;
+
+        return header_of(mapping)->frame_count.load(std::memory_order_acquire);
+    }
+
+    auto LiveFeedReader::read(const std::uint64_t& frame, Layer& state) const -> bool {
+        if (mapping == nullptr || frame >= frame_count())
+            return false;
+
+        if (state.get_width() != width || state.get_height() != height) {
+            std::cerr << "Error [LiveFeedReader::read]: Layer dimensions do not match the feed." << std::endl;
+            return false;
+        }
+
+        const auto stride = slot_stride(width, height);
+        const auto slot = static_cast<std::size_t>(frame % slot_count);
+        const auto expected = 2 * frame + 2;
+
+        const auto* sequence = slot_sequence(mapping, stride, slot);
+        if (sequence->load(std::memory_order_acquire) != expected)
+            return false;
+
+        std::memcpy(state.data(), slot_values(mapping, stride, slot), state.size() * sizeof(float));
+
+        // The publisher may have started overwriting the slot while we copied it
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return sequence->load(std::memory_order_relaxed) == expected;
+    }
+
+    auto LiveFeedReader::read_latest(Layer& state, std::uint64_t& frame) const -> bool {
+        for (auto attempt = 0; attempt < 8; ++attempt) {
+            const auto count = frame_count();
+            if (count == 0)
+                return false;
+
+            if (read(count - 1, state)) {
+                frame = count - 1;
+                return true;
+            }
+        }
+
+        return false;
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "layer.h"
+
+namespace m964 {
+    constexpr char LIVE_FEED_MAGIC[8] = { 'M', '9', '6', '4', 'F', 'E', 'E', 'D' };
+
+    // Publishes raw Layer frames into a POSIX shared memory ring buffer ("/m964_<name>"). Every slot is
+    // guarded by a seqlock, publish() is a single memcpy and never waits for readers; a reader that falls
+    // more than slot_count frames behind simply misses frames.
+    class LiveFeedPublisher {
+        private:
+            std::string shared_memory_name;
+            std::size_t width;
+            std::size_t height;
+            std::size_t slot_count;
+
+            void* mapping;
+            std::size_t mapping_size;
+            std::uint64_t published_frames;
+
+        public:
+            LiveFeedPublisher(const std::string& name, const std::size_t& width, const std::size_t& height, const std::size_t& slot_count = 4);
+            ~LiveFeedPublisher();
+
+            LiveFeedPublisher(const LiveFeedPublisher&) = delete;
+            auto operator=(const LiveFeedPublisher&) -> LiveFeedPublisher& = delete;
+
+            [[nodiscard]] auto is_open() const -> bool;
+            [[nodiscard]] auto get_published_frames() const -> std::uint64_t;
+
+            auto publish(const Layer& state) -> void;
+    };
+
+    // Attaches read-only to a feed created by LiveFeedPublisher
+    class LiveFeedReader {
+        private:
+            std::size_t width;
+            std::size_t height;
+            std::size_t slot_count;
+
+            const void* mapping;
+            std::size_t mapping_size;
+
+        public:
+            explicit LiveFeedReader(const std::string& name);
+            ~LiveFeedReader();
+
+            LiveFeedReader(const LiveFeedReader&) = delete;
+            auto operator=(const LiveFeedReader&) -> LiveFeedReader& = delete;
+
+            [[nodiscard]] auto is_open() const -> bool;
+            [[nodiscard]] auto get_width() const -> std::size_t;
+            [[nodiscard]] auto get_height() const -> std::size_t;
+
+            // Number of frames published so far, the newest one is frame_count() - 1
+            [[nodiscard]] auto frame_count() const -> std::uint64_t;
+
+            // Returns false if the frame was not published yet or has already been overwritten
+            auto read(const std::uint64_t& frame, Layer& state) const -> bool;
+
+            // Copies the newest complete frame and stores its number in `frame`
+            auto read_latest(Layer& state, std::uint64_t& frame) const -> bool;
+    };
+}
@@ -0,0 +1,225 @@
+#include "loss.h"
+#include "perf_counters.h"
+#include "kernels.h"
+
+#include <cmath>
+#include <algorithm>
+#include <string>
+#include <stdexcept>
+
+namespace m964 {
+    namespace {
+        constexpr std::size_t LOSS_LANES = 8;
+
+        // Element i of the whole reduction always lands in lane i % LOSS_LANES, no matter how it is fed in
+        struct LaneAccumulator {
+            float lanes[LOSS_LANES] = {};
+            std::size_t index = 0;
+
+            template<typename Term>
+            auto add(const std::size_t& count, const Term& term) -> void {
+                std::size_t i = 0;
+
+                for (; i < count && (index + i) % LOSS_LANES != 0; ++i)
+                    lanes[(index + i) % LOSS_LANES] += term(i);
+
+                for (; i + LOSS_LANES <= count; i += LOSS_LANES)
+                    for (std::size_t lane = 0; lane < LOSS_LANES; ++lane)
+                        lanes[lane] += term(i + lane);
+
+                for (; i < count; ++i)
+                    lanes[(index + i) % LOSS_LANES] += term(i);
+
+                index += count;
+            }
+
+            [[nodiscard]] auto total() const -> float {
+                return ((lanes[0] + lanes[4]) + (lanes[2] + lanes[6])) + ((lanes[1] + lanes[5]) + (lanes[3] + lanes[7]));
+            }
+        };
+
+        struct SquaredDifference {
+            auto operator()(const float& a, const float& b) const -> float {
+                const auto difference = a - b;
+                return difference * difference;
+            }
+        };
+
+        struct AbsoluteDifference {
+            auto operator()(const float& a, const float& b) const -> float {
+                return std::fabs(a - b);
+            }
+        };
+
+        auto check_dimensions(const Layer& a, const Layer& b, const char* function) -> void {
+            if (a.get_width() != b.get_width() || a.get_height() != b.get_height())
+                throw std::invalid_argument(std::string(function) + ": layer dimensions do not match");
+        }
+
+        auto reduce(const float& total, const float& count, const LossReduction& reduction) -> float {
+            if (reduction == LossReduction::Sum)
+                return total;
+
+            return count > 0.0f ? total / count : 0.0f;
+        }
+
+        template<typename Difference>
+        auto accumulate(LaneAccumulator& loss, LaneAccumulator& weights, const float* state, const float* target, const float* mask, const std::size_t& count, const Difference& difference) -> void {
+            if (mask == nullptr) {
+                loss.add(count, [&](const std::size_t& i) { return difference(state[i], target[i]); });
+                return;
+            }
+
+            loss.add(count, [&](const std::size_t& i) { return mask[i] * difference(state[i], target[i]); });
+            weights.add(count, [&](const std::size_t& i) { return mask[i]; });
+        }
+
+        auto accumulate(LaneAccumulator& loss, LaneAccumulator& weights, const float* state, const float* target, const float* mask, const std::size_t& count, const LossKind& kind) -> void {
+            const auto generic = [&](const std::size_t& offset, const std::size_t& length) {
+                const auto* mask_offset = mask != nullptr ? mask + offset : nullptr;
+
+                if (kind == LossKind::SquaredError)
+                    accumulate(loss, weights, state + offset, target + offset, mask_offset, length, SquaredDifference{});
+                else
+                    accumulate(loss, weights, state + offset, target + offset, mask_offset, length, AbsoluteDifference{});
+            };
+
+            // Elements up to the next lane boundary and the remainder go through the accumulator,
+            // whole blocks of LOSS_LANES elements through the vectorized kernel. The lane of every element is unchanged.
+            const auto head = std::min(count, (LOSS_LANES - loss.index % LOSS_LANES) % LOSS_LANES);
+            const auto blocks = (count - head) / LOSS_LANES * LOSS_LANES;
+
+            generic(0, head);
+
+            if (blocks > 0) {
+                const auto& kernels = active_kernels();
+                const auto* mask_offset = mask != nullptr ? mask + head : nullptr;
+
+                if (kind == LossKind::SquaredError)
+                    kernels.squared_error_lanes(loss.lanes, state + head, target + head, mask_offset, blocks);
+                else
+                    kernels.absolute_error_lanes(loss.lanes, state + head, target + head, mask_offset, blocks);
+
+                loss.index += blocks;
+
+                if (mask != nullptr) {
+                    kernels.sum_lanes(weights.lanes, mask_offset, blocks);
+                    weights.index += blocks;
+                }
+            }
+
+            generic(head + blocks, count - head - blocks);
+        }
+    }
+
+    auto mse_loss(const Layer& state, const Layer& target, const LossReduction& reduction) -> float {
+        const auto perf_scope = PerfScope(PerfRegion::Loss);
+
+        check_dimensions(state, target, "mse_loss");
+
+        auto loss = LaneAccumulator{};
+        auto weights = LaneAccumulator{};
+        accumulate(loss, weights, state.data(), target.data(), nullptr, state.size(), SquaredDifference{});
+
+        return reduce(loss.total(), static_cast<float>(state.size()), reduction);
+    }
+
+    auto l1_loss(const Layer& state, const Layer& target, const LossReduction& reduction) -> float {
+        const auto perf_scope = PerfScope(PerfRegion::Loss);
+
+        check_dimensions(state, target, "l1_loss");
+
+        auto loss = LaneAccumulator{};
+        auto weights = LaneAccumulator{};
+        accumulate(loss, weights, state.data(), target.data(), nullptr, state.size(), AbsoluteDifference{});
+
+        return reduce(loss.total(), static_cast<float>(state.size()), reduction);
+    }
+
+    auto masked_mse_loss(const Layer& state, const Layer& target, const Layer& mask, const LossReduction& reduction) -> float {
+        const auto perf_scope = PerfScope(PerfRegion::Loss);
+
+        check_dimensions(state, target, "masked_mse_loss");
+        check_dimensions(state, mask, "masked_mse_loss");
+
+        auto loss = LaneAccumulator{};
+        auto weights = LaneAccumulator{};
+        accumulate(loss, weights, state.data(), target.data(), mask.data(), state.size(), SquaredDifference{});
+
+        return reduce(loss.total(), weights.total(), reduction);
+    }
+
+    auto masked_l1_loss(const Layer& state, const Layer& target, const Layer& mask, const LossReduction& reduction) -> float {
+        const auto perf_scope = PerfScope(PerfRegion::Loss);
+
+        check_dimensions(state, target, "masked_l1_loss");
+        check_dimensions(state, mask, "masked_l1_loss");
+
+        auto loss = LaneAccumulator{};
+        auto weights = LaneAccumulator{};
+        accumulate(loss, weights, state.data(), target.data(), mask.data(), state.size(), AbsoluteDifference{});
+
+        return reduce(loss.total(), weights.total(), reduction);
+    }
+
+    auto probe_loss(const Layer& state, const std::vector<ProbeCell>& probes, const LossKind& kind, const LossReduction& reduction) -> float {
+        const auto perf_scope = PerfScope(PerfRegion::Loss);
+
+        auto loss = LaneAccumulator{};
+        auto weights = LaneAccumulator{};
+
+        loss.add(probes.size(), [&](const std::size_t& i) {
+            const auto& probe = probes[i];
+            const auto value = state(probe.x, probe.y);
+
+            if (kind == LossKind::SquaredError)
+                return probe.weight * SquaredDifference{}(value, probe.target);
+
+            return probe.weight * AbsoluteDifference{}(value, probe.target);
+        });
+
+        weights.add(probes.size(), [&](const std::size_t& i) { return probes[i].weight; });
+
+        return reduce(loss.total(), weights.total(), reduction);
+    }
+
+    auto simulate_step_with_loss(Model& model, const Layer& target, const LossKind& kind, const LossReduction& reduction, const Layer* mask) -> float {
+        const auto perf_scope = PerfScope(PerfRegion::Loss);
+
+        auto& o_state = model.get_old_state();
+        auto& n_state = model.get_new_state();
+
+        check_dimensions(n_state, target, "simulate_step_with_loss");
+        if (mask != nullptr)
+            check_dimensions(n_state, *mask, "simulate_step_with_loss");
+
+        calculate_state(n_state, o_state, model.weights);
+
+        const auto width = n_state.get_width();
+        const auto height = n_state.get_height();
+        const auto* biases = model.bias_layer.data();
+        const auto* target_values = target.data();
+        const auto* mask_values = mask != nullptr ? mask->data() : nullptr;
+        auto* values = n_state.data();
+
+        auto loss = LaneAccumulator{};
+        auto weights = LaneAccumulator{};
+
+        const auto& kernels = active_kernels();
+
+        for (std::size_t y = 0; y < height; ++y) {
+            const auto offset = y * width;
+            auto* row = values + offset;
+
+            // Matches calculate_state_with_biases, which leaves the first row and column without bias
+            kernels.bias_relu_rows(values, biases, width, y, y + 1);
+
+            accumulate(loss, weights, row, target_values + offset, mask_values != nullptr ? mask_values + offset : nullptr, width, kind);
+        }
+
+        std::swap(model.old_state, model.new_state);
+
+        const auto count = mask != nullptr ? weights.total() : static_cast<float>(n_state.size());
+        return reduce(loss.total(), count, reduction);
+    }
+}
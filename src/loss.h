@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "layer.h"
+#include "model.h"
+
+namespace m964 {
+    enum class LossKind {
+        SquaredError,
+        AbsoluteError
+    };
+
+    enum class LossReduction {
+        Mean,
+        Sum
+    };
+
+    struct ProbeCell {
+        std::size_t x;
+        std::size_t y;
+        float target;
+        float weight = 1.0f;
+    };
+
+    // All reductions accumulate into eight fixed lanes in cell order and combine them in a fixed tree,
+    // so the result does not depend on how (or whether) the compiler vectorizes the loops.
+    auto mse_loss(const Layer& state, const Layer& target, const LossReduction& reduction = LossReduction::Mean) -> float;
+    auto l1_loss(const Layer& state, const Layer& target, const LossReduction& reduction = LossReduction::Mean) -> float;
+
+    // Mean reduction divides by the sum of the mask weights
+    auto masked_mse_loss(const Layer& state, const Layer& target, const Layer& mask, const LossReduction& reduction = LossReduction::Mean) -> float;
+    auto masked_l1_loss(const Layer& state, const Layer& target, const Layer& mask, const LossReduction& reduction = LossReduction::Mean) -> float;
+
+    auto probe_loss(const Layer& state, const std::vector<ProbeCell>& probes, const LossKind& kind = LossKind::SquaredError, const LossReduction& reduction = LossReduction::Mean) -> float;
+
+    // Same as model.simulate_step_with_biases() followed by mse_loss / l1_loss (masked_mse_loss / masked_l1_loss when
+    // a mask is given) on the new state, but the loss is accumulated row by row while the row is still in cache.
+    auto simulate_step_with_loss(
+        Model& model,
+        const Layer& target,
+        const LossKind& kind = LossKind::SquaredError,
+        const LossReduction& reduction = LossReduction::Mean,
+        const Layer* mask = nullptr
+    ) -> float;
+}
@@ -1,35 +1,121 @@
 #include "model.h"
+#include "perf_counters.h"
+#include "kernels.h"
 #include <stdexcept> // For runtime_error, if you choose to use exceptions
+#include <algorithm>
+#include <iterator>
+#include <memory>
 
 namespace m964 {
-    Model::Model(
-    ) : width(DEFAULT_MODEL_STATE_DIM_X),
-        height(DEFAULT_MODEL_STATE_DIM_Y),
-        bias_layer(width, height),
-        weights(DEFAULT_MODEL_STATE_DIM_X, DEFAULT_MODEL_STATE_DIM_Y),
-        old_state(0),
-        new_state(0) // KernelLayer constructor called with model dimensions
-    {
-            states.emplace_back(width, height);
-            states.emplace_back(width, height);
-            reset_states(); // This will also call fill_states
+    Model::Model() : Model(DEFAULT_MODEL_STATE_DIM_X, DEFAULT_MODEL_STATE_DIM_Y) {
+
     }
 
     Model::Model(
         const std::size_t& width,
         const std::size_t& height
-    ) : width(width),
+    ) : parameter_storage(width * height * PARAMETERS_PER_CELL),
+        width(width),
         height(height),
-        bias_layer(width, height),
-        weights(width, height),
+        bias_layer(width, height, parameter_storage.data()),
+        weights(width, height, reinterpret_cast<Kernel*>(parameter_storage.data() + width * height)),
         old_state(0),
-        new_state(0) // KernelLayer constructor called with model dimensions
+        new_state(0)
     {
         states.emplace_back(width, height);
         states.emplace_back(width, height);
         reset_states(); // This will also call fill_states
     }
 
+    Model::Model(
+        const Model& other
+    ) : parameter_storage(other.parameter_storage),
+        width(other.width),
+        height(other.height),
+        bias_layer(width, height, parameter_storage.data()),
+        states(other.states),
+        weights(width, height, reinterpret_cast<Kernel*>(parameter_storage.data() + width * height)),
+        old_state(other.old_state),
+        new_state(other.new_state)
+    {
+
+    }
+
+    Model::Model(
+        Model&& other
+    ) noexcept : parameter_storage(std::move(other.parameter_storage)),
+        width(other.width),
+        height(other.height),
+        bias_layer(width, height, parameter_storage.data()),
+        states(std::move(other.states)),
+        weights(width, height, reinterpret_cast<Kernel*>(parameter_storage.data() + width * height)),
+        old_state(other.old_state),
+        new_state(other.new_state)
+    {
+        // The views of other still refer to the moved buffer
+        other.width = 0;
+        other.height = 0;
+        other.parameter_storage.clear();
+        other.bind_parameters();
+    }
+
+    auto Model::operator=(const Model& other) -> Model& {
+        if (this == &other)
+            return *this;
+
+        if (width == other.width && height == other.height) {
+            std::copy(other.parameter_storage.begin(), other.parameter_storage.end(), parameter_storage.begin());
+        } else {
+            parameter_storage = other.parameter_storage;
+            width = other.width;
+            height = other.height;
+            bind_parameters();
+        }
+
+        states = other.states;
+        old_state = other.old_state;
+        new_state = other.new_state;
+
+        return *this;
+    }
+
+    auto Model::operator=(Model&& other) noexcept -> Model& {
+        if (this == &other)
+            return *this;
+
+        parameter_storage = std::move(other.parameter_storage);
+        width = other.width;
+        height = other.height;
+        bind_parameters();
+
+        states = std::move(other.states);
+        old_state = other.old_state;
+        new_state = other.new_state;
+
+        other.width = 0;
+        other.height = 0;
+        other.parameter_storage.clear();
+        other.bind_parameters();
+
+        return *this;
+    }
+
+    auto Model::bind_parameters() -> void {
+        std::destroy_at(&bias_layer);
+        std::construct_at(&bias_layer, width, height, parameter_storage.data());
+
+        std::destroy_at(&weights);
+        std::construct_at(&weights, width, height, reinterpret_cast<Kernel*>(parameter_storage.data() + width * height));
+    }
+
+    auto Model::parameters() -> std::span<float> {
+        return std::span<float>(parameter_storage.data(), parameter_storage.size());
+    }
+
+    auto Model::parameters() const -> std::span<const float> {
+        return std::span<const float>(parameter_storage.data(), parameter_storage.size());
+    }
+
     auto Model::reset_states() -> void {
         old_state = 0;
         new_state = 1;
@@ -54,12 +140,13 @@ namespace m964 {
     }
 
     auto Model::simulate_step() -> void {
+        const auto perf_scope = PerfScope(PerfRegion::Step);
+
         // Ensure states are valid before proceeding
         if (old_state >= states.size() || new_state >= states.size()) {
             std::cerr << "Error [Model::simulate_step]: State indices invalid. Cannot simulate." << std::endl;
             return;
         }
-        auto& biases = bias_layer;
         auto& o_state = get_old_state();
         auto& n_state = get_new_state();
 
@@ -67,26 +154,28 @@ namespace m964 {
 
         // n_state.apply(NormalizeValue());
         // n_state.apply(SigmoidValue{});
-        n_state.apply(ReluValue());
+        active_kernels().relu(n_state.data(), n_state.size());
 
         std::swap(old_state, new_state);
     }
 
     auto Model::simulate_step_with_biases() -> void {
+        const auto perf_scope = PerfScope(PerfRegion::Step);
+
         // Ensure states are valid before proceeding
         if (old_state >= states.size() || new_state >= states.size()) {
             std::cerr << "Error [Model::simulate_step]: State indices invalid. Cannot simulate." << std::endl;
             return;
         }
-        auto& biases = bias_layer;
         auto& o_state = get_old_state();
         auto& n_state = get_new_state();
 
-        calculate_state_with_biases(n_state, o_state, biases, weights);
+        calculate_state(n_state, o_state, weights);
 
+        // Same as calculate_state_with_biases followed by ReluValue, in one pass
         // n_state.apply(NormalizeValue());
         // n_state.apply(SigmoidValue{});
-        n_state.apply(ReluValue());
+        active_kernels().bias_relu_rows(n_state.data(), bias_layer.data(), width, 0, height);
 
         std::swap(old_state, new_state);
     }
@@ -111,110 +200,248 @@ namespace m964 {
         return states[old_state];
     }
 
-    // calculate_state function remains unchanged
-    auto calculate_state(Layer& new_state, const Layer& state,  const KernelLayer& weights) -> void {
-        const auto width = new_state.get_width();
-        const auto height = new_state.get_height();
+    auto Model::has_states() const -> bool {
+        return states.size() >= 2;
+    }
 
-        const auto width_m = width - 1;
-        const auto height_m = height - 1;
+    auto Model::release_states() -> std::vector<Layer> {
+        auto buffers = std::move(states);
+        states.clear();
 
-        { // top left
-            const auto& kernel = weights(0, 0);
-            auto value = state(0, 0) * kernel(1, 1);
-            value += state(0, 0 + 1) * kernel(1, 2);
-            value += state(0 + 1, 0) * kernel(2, 1);
-            value += state(0 + 1, 0 + 1) * kernel(2, 2);
-            new_state(0, 0) = value;
-        }
+        return buffers;
+    }
 
-        { // top right
-            const auto& kernel = weights(width_m, 0);
-            auto value = state(width_m, 0) * kernel(1, 1);
-            value += state(width_m, 0 + 1) * kernel(1, 2);
-            value += state(width_m - 1, 0) * kernel(0, 1);
-            value += state(width_m - 1, 0 + 1) * kernel(0, 2);
-            new_state(width_m, 0) = value;
-        }
+    auto Model::adopt_states(std::vector<Layer> buffers) -> void {
+        if (buffers.size() != 2)
+            throw std::invalid_argument("Model::adopt_states: expected two state buffers");
 
-        { // bottom left
-            const auto& kernel = weights(0, height_m);
-            auto value = state(0, height_m) * kernel(1, 1);
-            value += state(0, height_m - 1) * kernel(1, 0);
-            value += state(0 + 1, height_m) * kernel(2, 1);
-            value += state(0 + 1, height_m - 1) * kernel(2, 0);
-            new_state(0, height_m) = value;
-        }
+        for (const auto& buffer : buffers)
+            if (buffer.get_width() != width || buffer.get_height() != height)
+                throw std::invalid_argument("Model::adopt_states: state buffer dimensions do not match the model");
+
+        states = std::move(buffers);
+        reset_states();
+    }
+
+    auto Model::allocate_states() -> void {
+        if (has_states())
+            return;
+
+        auto buffers = std::vector<Layer>{};
+        buffers.emplace_back(width, height);
+        buffers.emplace_back(width, height);
+
+        adopt_states(std::move(buffers));
+    }
+
+    auto Model::save(std::ostream& stream) const -> void {
+        const std::uint64_t dimensions[2] = { width, height };
 
-        { // bottom right
-            const auto& kernel = weights(width_m, height_m);
-            auto value = state(width_m, height_m) * kernel(1, 1);
-            value += state(width_m, height_m - 1) * kernel(1, 0);
-            value += state(width_m - 1, height_m) * kernel(0, 1);
-            value += state(width_m - 1, height_m - 1) * kernel(0, 0);
-            new_state(width_m, height_m) = value;
+        stream.write(MODEL_FILE_MAGIC, sizeof(MODEL_FILE_MAGIC));
+        stream.write(reinterpret_cast<const char*>(dimensions), sizeof(dimensions));
+        stream.write(reinterpret_cast<const char*>(parameter_storage.data()), static_cast<std::streamsize>(parameter_storage.size() * sizeof(float)));
+    }
+
+    auto Model::serialized_size(const std::size_t& width, const std::size_t& height) -> std::size_t {
+        return sizeof(MODEL_FILE_MAGIC) + 2 * sizeof(std::uint64_t) + width * height * PARAMETERS_PER_CELL * sizeof(float);
+    }
+
+    auto Model::is_loadable_size(const std::uint64_t& width, const std::uint64_t& height) -> bool {
+        return width > 0 && height > 0 && width <= MAX_LOADED_MODEL_CELLS && height <= MAX_LOADED_MODEL_CELLS / width;
+    }
+
+    namespace {
+        // Model::load with optional expected dimensions, checked before anything is allocated
+        auto load_model(std::istream& stream, const std::size_t* expected_width, const std::size_t* expected_height) -> std::optional<Model> {
+            char magic[sizeof(MODEL_FILE_MAGIC)];
+            std::uint64_t dimensions[2] = { 0, 0 };
+
+            stream.read(magic, sizeof(magic));
+            stream.read(reinterpret_cast<char*>(dimensions), sizeof(dimensions));
+
+            if (!stream || !std::equal(std::begin(magic), std::end(magic), std::begin(MODEL_FILE_MAGIC))) {
+                std::cerr << "Error [Model::load]: Stream does not contain a serialized model." << std::endl;
+                return std::nullopt;
+            }
+
+            if (!Model::is_loadable_size(dimensions[0], dimensions[1])) {
+                std::cerr << "Error [Model::load]: Serialized model has invalid dimensions " << dimensions[0] << "x" << dimensions[1] << "." << std::endl;
+                return std::nullopt;
+            }
+
+            if (expected_width && expected_height && (dimensions[0] != *expected_width || dimensions[1] != *expected_height)) {
+                std::cerr << "Error [Model::load]: Serialized model is " << dimensions[0] << "x" << dimensions[1] << ", expected " << *expected_width << "x" << *expected_height << "." << std::endl;
+                return std::nullopt;
+            }
+
+            // A seekable stream tells how much is left, a header promising more than that is not worth allocating for
+            const auto payload_size = Model::serialized_size(dimensions[0], dimensions[1]) - sizeof(MODEL_FILE_MAGIC) - sizeof(dimensions);
+            const auto position = stream.tellg();
+
+            if (position != std::istream::pos_type(-1)) {
+                stream.seekg(0, std::ios::end);
+                const auto remaining = static_cast<std::uint64_t>(stream.tellg() - position);
+                stream.seekg(position);
+
+                if (remaining < payload_size) {
+                    std::cerr << "Error [Model::load]: Serialized model is truncated." << std::endl;
+                    return std::nullopt;
+                }
+            }
+
+            auto model = Model(dimensions[0], dimensions[1]);
+            const auto values = model.parameters();
+            stream.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(values.size_bytes()));
+
+            if (!stream) {
+                std::cerr << "Error [Model::load]: Serialized model is truncated." << std::endl;
+                return std::nullopt;
+            }
+
+            return model;
         }
+    }
+
+    auto Model::load(std::istream& stream) -> std::optional<Model> {
+        return load_model(stream, nullptr, nullptr);
+    }
+
+    auto Model::load(std::istream& stream, const std::size_t& width, const std::size_t& height) -> std::optional<Model> {
+        return load_model(stream, &width, &height);
+    }
+
+    namespace {
+        // One cell on the border of the grid. The corners and edges drop the missing neighbours, each keeps its own summation order.
+        auto border_value(const Layer& state, const KernelLayer& weights, const std::size_t& x, const std::size_t& y) -> float {
+            const auto width_m = state.get_width() - 1;
+            const auto height_m = state.get_height() - 1;
+            const auto& kernel = weights(x, y);
 
-        for(std::size_t x = 1; x < width_m; ++x) {
-            { // Top edge
-                const auto& kernel = weights(x, 0);
+            if (y == 0) {
+                if (x == 0) { // top left
+                    auto value = state(0, 0) * kernel(1, 1);
+                    value += state(0, 0 + 1) * kernel(1, 2);
+                    value += state(0 + 1, 0) * kernel(2, 1);
+                    value += state(0 + 1, 0 + 1) * kernel(2, 2);
+                    return value;
+                }
+
+                if (x == width_m) { // top right
+                    auto value = state(width_m, 0) * kernel(1, 1);
+                    value += state(width_m, 0 + 1) * kernel(1, 2);
+                    value += state(width_m - 1, 0) * kernel(0, 1);
+                    value += state(width_m - 1, 0 + 1) * kernel(0, 2);
+                    return value;
+                }
+
+                // Top edge
                 auto value = state(x, 0) * kernel(1, 1);
                 value += state(x, 0 + 1) * kernel(1, 2);
                 value += state(x + 1, 0) * kernel(2, 1);
                 value += state(x - 1, 0) * kernel(0, 1);
                 value += state(x + 1, 0 + 1) * kernel(2, 2);
                 value += state(x - 1, 0 + 1) * kernel(0, 2);
-                new_state(x, 0) = value;
+                return value;
             }
-            { // Bottom edge
-                const auto& kernel = weights(x, height_m);
+
+            if (y == height_m) {
+                if (x == 0) { // bottom left
+                    auto value = state(0, height_m) * kernel(1, 1);
+                    value += state(0, height_m - 1) * kernel(1, 0);
+                    value += state(0 + 1, height_m) * kernel(2, 1);
+                    value += state(0 + 1, height_m - 1) * kernel(2, 0);
+                    return value;
+                }
+
+                if (x == width_m) { // bottom right
+                    auto value = state(width_m, height_m) * kernel(1, 1);
+                    value += state(width_m, height_m - 1) * kernel(1, 0);
+                    value += state(width_m - 1, height_m) * kernel(0, 1);
+                    value += state(width_m - 1, height_m - 1) * kernel(0, 0);
+                    return value;
+                }
+
+                // Bottom edge
                 auto value = state(x, height_m) * kernel(1, 1);
                 value += state(x, height_m - 1) * kernel(1, 0);
                 value += state(x + 1, height_m) * kernel(2, 1);
                 value += state(x - 1, height_m) * kernel(0, 1);
                 value += state(x + 1, height_m - 1) * kernel(2, 0);
                 value += state(x - 1, height_m - 1) * kernel(0, 0);
-                new_state(x, height_m) = value;
+                return value;
             }
-        }
 
-        for(std::size_t y = 1; y < height_m; ++y) {
-            { // Left edge
-                const auto& kernel = weights(0, y);
+            if (x == 0) { // Left edge
                 auto value = state(0, y) * kernel(1, 1);
                 value += state(0, y + 1) * kernel(1, 2);
                 value += state(0, y - 1) * kernel(1, 0);
                 value += state(0 + 1, y) * kernel(2, 1);
                 value += state(0 + 1, y + 1) * kernel(2, 2);
                 value += state(0 + 1, y - 1) * kernel(2, 0);
-                new_state(0, y) = value;
-            }
-            { // Right edge
-                const auto& kernel = weights(width_m, y);
-                auto value = state(width_m, y) * kernel(1, 1);
-                value += state(width_m, y + 1) * kernel(1, 2);
-                value += state(width_m, y - 1) * kernel(1, 0);
-                value += state(width_m - 1, y) * kernel(0, 1);
-                value += state(width_m - 1, y + 1) * kernel(0, 2);
-                value += state(width_m - 1, y - 1) * kernel(0, 0);
-                new_state(width_m, y) = value;
+                return value;
             }
+
+            // Right edge
+            auto value = state(width_m, y) * kernel(1, 1);
+            value += state(width_m, y + 1) * kernel(1, 2);
+            value += state(width_m, y - 1) * kernel(1, 0);
+            value += state(width_m - 1, y) * kernel(0, 1);
+            value += state(width_m - 1, y + 1) * kernel(0, 2);
+            value += state(width_m - 1, y - 1) * kernel(0, 0);
+            return value;
         }
+    }
 
-        for(std::size_t x = 1; x < width_m; ++x) {
-            for(std::size_t y = 1; y < height_m; ++y) {
-                const auto& kernel = weights(x, y);
-                auto value = state(x, y) * kernel(1, 1);
-                value += state(x, y + 1) * kernel(1, 2);
-                value += state(x, y - 1) * kernel(1, 0);
-                value += state(x + 1, y) * kernel(2, 1);
-                value += state(x - 1, y) * kernel(0, 1);
-                value += state(x + 1, y + 1) * kernel(2, 2);
-                value += state(x - 1, y - 1) * kernel(0, 0);
-                value += state(x + 1, y - 1) * kernel(2, 0);
-                value += state(x - 1, y + 1) * kernel(0, 2);
-                new_state(x, y) = value;
-            }
+    auto calculate_state(Layer& new_state, const Layer& state,  const KernelLayer& weights) -> void {
+        calculate_state_region(new_state, state, weights, 0, new_state.get_width(), 0, new_state.get_height());
+    }
+
+    auto calculate_state_region(
+        Layer& new_state,
+        const Layer& state,
+        const KernelLayer& weights,
+        const std::size_t& x_begin,
+        const std::size_t& x_end,
+        const std::size_t& y_begin,
+        const std::size_t& y_end
+    ) -> void {
+        const auto width = new_state.get_width();
+        const auto height = new_state.get_height();
+
+        const auto width_m = width - 1;
+        const auto height_m = height - 1;
+
+        // Border rows and columns inside the region
+        for (auto x = x_begin; x < x_end; ++x) {
+            if (y_begin == 0)
+                new_state(x, 0) = border_value(state, weights, x, 0);
+            if (y_end == height)
+                new_state(x, height_m) = border_value(state, weights, x, height_m);
+        }
+
+        const auto inner_y_begin = std::max<std::size_t>(y_begin, 1);
+        const auto inner_y_end = std::min(y_end, height_m);
+
+        for (auto y = inner_y_begin; y < inner_y_end; ++y) {
+            if (x_begin == 0)
+                new_state(0, y) = border_value(state, weights, 0, y);
+            if (x_end == width)
+                new_state(width_m, y) = border_value(state, weights, width_m, y);
+        }
+
+        static_assert(sizeof(Kernel) == 9 * sizeof(float), "Kernel layers are read as 9 floats per cell");
+
+        const auto inner_x_begin = std::max<std::size_t>(x_begin, 1);
+        const auto inner_x_end = std::min(x_end, width_m);
+
+        if (inner_x_begin < inner_x_end && inner_y_begin < inner_y_end) {
+            const auto& kernels = active_kernels();
+            const auto* weight_values = reinterpret_cast<const float*>(weights.data());
+
+            if (inner_x_begin == 1 && inner_x_end == width_m && inner_y_begin == 1 && inner_y_end == height_m)
+                kernels.step_interior(new_state.data(), state.data(), weight_values, width, height);
+            else
+                kernels.step_interior_rect(new_state.data(), state.data(), weight_values, width, inner_x_begin, inner_x_end, inner_y_begin, inner_y_end);
         }
     }
 
@@ -1,12 +1,15 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <iostream>
 #include <fstream>   // For file operations
 #include <string>    // For filename
 #include <optional>  // For std::optional
+#include <span>
 
+#include "aligned_allocator.h"
 #include "layer.h"
 #include "kernel_layer.h"
 #include "utils.h"
@@ -18,7 +21,22 @@ namespace m964 {
     constexpr std::size_t DEFAULT_MODEL_STATE_DIM_X = 8;
     constexpr std::size_t DEFAULT_MODEL_STATE_DIM_Y = 8;
 
+    // A bias and the 9 weights of the cell's kernel
+    constexpr std::size_t PARAMETERS_PER_CELL = 1 + sizeof(Kernel) / sizeof(float);
+
+    constexpr char MODEL_FILE_MAGIC[8] = { 'M', '9', '6', '4', 'M', 'O', 'D', 'L' };
+
+    // Largest grid Model::load and replay_model_lineage accept, a 8192x8192 model. Bigger headers are treated as corrupt.
+    constexpr std::size_t MAX_LOADED_MODEL_CELLS = std::size_t{1} << 26;
+
     class Model {
+        private:
+            // All trainable parameters, bias_layer and weights are views into it (see parameters())
+            std::vector<float, AlignedAllocator<float>> parameter_storage;
+
+            // Points bias_layer and weights at parameter_storage again after it was reallocated
+            auto bind_parameters() -> void;
+
         public:
             std::size_t width;
             std::size_t height;
@@ -34,6 +52,16 @@ namespace m964 {
             Model();
             Model(const std::size_t& width, const std::size_t& height);
 
+            Model(const Model& other);
+            Model(Model&& other) noexcept;
+            auto operator=(const Model& other) -> Model&;
+            auto operator=(Model&& other) noexcept -> Model&;
+
+            // The biases row-major, followed by the 9 weights of every cell's kernel, in one contiguous aligned buffer.
+            // Whole-model operations (noise, axpy, copies, hashing) are a single pass over it, it is also the layout of save().
+            [[nodiscard]] auto parameters() -> std::span<float>;
+            [[nodiscard]] auto parameters() const -> std::span<const float>;
+
             auto reset_states() -> void;
             auto fill_states(const float& value) -> void;
             auto simulate_step() -> void;
@@ -41,8 +69,33 @@ namespace m964 {
 
             auto get_new_state() -> Layer&;
             auto get_old_state() -> Layer&;
+
+            // The two simulation buffers are execution state, not parameters. A model without them (see SimulationScratch)
+            // is cheap to copy and has to adopt buffers before it can be stepped.
+            [[nodiscard]] auto has_states() const -> bool;
+            auto release_states() -> std::vector<Layer>;
+            auto adopt_states(std::vector<Layer> buffers) -> void; // resets them like reset_states()
+            auto allocate_states() -> void; // fresh buffers for a model without states
+
+            // Binary serialization of the trainable parameters (bias_layer and weights)
+            auto save(std::ostream& stream) const -> void;
+            static auto serialized_size(const std::size_t& width, const std::size_t& height) -> std::size_t; // bytes written by save()
+            static auto is_loadable_size(const std::uint64_t& width, const std::uint64_t& height) -> bool; // non-zero, at most MAX_LOADED_MODEL_CELLS
+            static auto load(std::istream& stream) -> std::optional<Model>;
+            static auto load(std::istream& stream, const std::size_t& width, const std::size_t& height) -> std::optional<Model>; // rejects other dimensions
     };
 
     auto calculate_state(Layer& new_state, const Layer& state, const KernelLayer& weights) -> void;
+
+    // calculate_state for the cells in columns [x_begin, x_end) and rows [y_begin, y_end), the other cells of new_state are not written
+    auto calculate_state_region(
+        Layer& new_state,
+        const Layer& state,
+        const KernelLayer& weights,
+        const std::size_t& x_begin,
+        const std::size_t& x_end,
+        const std::size_t& y_begin,
+        const std::size_t& y_end
+    ) -> void;
     auto calculate_state_with_biases(Layer& new_state, const Layer& state,  const Layer& biases, const KernelLayer& weights) -> void;
 }
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include "model_batch.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "kernels.h"
+#include "perf_counters.h"
+
+namespace m964 {
+    ModelBatch::ModelBatch(
+        const std::size_t& width,
+        const std::size_t& height
+    ) : width(width),
+        height(height),
+        states { std::vector<float, AlignedAllocator<float>>(width * height * MODEL_BATCH_LANES), std::vector<float, AlignedAllocator<float>>(width * height * MODEL_BATCH_LANES) },
+        weights(width * height * 9 * MODEL_BATCH_LANES),
+        biases(width * height * MODEL_BATCH_LANES) {
+
+    }
+
+    auto ModelBatch::get_width() const -> std::size_t {
+        return width;
+    }
+
+    auto ModelBatch::get_height() const -> std::size_t {
+        return height;
+    }
+
+    auto ModelBatch::step(std::span<Model* const> models, const std::size_t& steps, const bool& use_biases) -> void {
+        if (models.size() > MODEL_BATCH_LANES || width < 3 || height < 3)
+            throw std::invalid_argument("ModelBatch::step: too many models or the batch is smaller than 3x3");
+
+        for (const auto* model : models)
+            if (model->width != width || model->height != height || !model->has_states())
+                throw std::invalid_argument("ModelBatch::step: model dimensions do not match the batch or the model has no states");
+
+        if (models.empty() || steps == 0)
+            return;
+
+        const auto perf_scope = PerfScope(PerfRegion::Step);
+        const auto cells = width * height;
+
+        // Unused lanes step zeros, so they never produce denormals or NaNs from stale values
+        for (auto lane = models.size(); lane < MODEL_BATCH_LANES; ++lane)
+            for (std::size_t cell = 0; cell < cells; ++cell)
+                states[0][cell * MODEL_BATCH_LANES + lane] = 0.0f;
+
+        for (std::size_t lane = 0; lane < models.size(); ++lane) {
+            auto& model = *models[lane];
+            const auto* state = model.get_old_state().data();
+            const auto* kernels = reinterpret_cast<const float*>(model.weights.data());
+            const auto* bias = model.bias_layer.data();
+
+            for (std::size_t cell = 0; cell < cells; ++cell) {
+                states[0][cell * MODEL_BATCH_LANES + lane] = state[cell];
+                biases[cell * MODEL_BATCH_LANES + lane] = bias[cell];
+
+                for (std::size_t k = 0; k < 9; ++k)
+                    weights[(cell * 9 + k) * MODEL_BATCH_LANES + lane] = kernels[cell * 9 + k];
+            }
+        }
+
+        const auto& kernels = active_kernels();
+
+        for (std::size_t t = 0; t < steps; ++t)
+            kernels.step_lanes(states[(t + 1) % 2].data(), states[t % 2].data(), weights.data(), use_biases ? biases.data() : nullptr, width, height);
+
+        const auto& last = states[steps % 2];
+        const auto& previous = states[(steps + 1) % 2];
+
+        for (std::size_t lane = 0; lane < models.size(); ++lane) {
+            auto& model = *models[lane];
+            auto* last_state = model.get_old_state().data();
+            auto* previous_state = model.get_new_state().data();
+
+            for (std::size_t cell = 0; cell < cells; ++cell) {
+                last_state[cell] = last[cell * MODEL_BATCH_LANES + lane];
+                previous_state[cell] = previous[cell * MODEL_BATCH_LANES + lane];
+            }
+        }
+    }
+}
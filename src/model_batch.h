@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "aligned_allocator.h"
+#include "model.h"
+
+namespace m964 {
+    // Lanes of KernelTable::step_lanes
+    constexpr std::size_t MODEL_BATCH_LANES = 8;
+
+    // Steps up to MODEL_BATCH_LANES models of the same size together. Their states and parameters are interleaved cell by
+    // cell, so every cell of all models is one contiguous vector operation, borders included, and a kernel is read with
+    // unit stride instead of 9 floats apart. The parameters are packed again on every call, a model may change in between.
+    class ModelBatch {
+        private:
+            std::size_t width;
+            std::size_t height;
+
+            std::vector<float, AlignedAllocator<float>> states[2];
+            std::vector<float, AlignedAllocator<float>> weights;
+            std::vector<float, AlignedAllocator<float>> biases;
+
+        public:
+            ModelBatch(const std::size_t& width, const std::size_t& height);
+
+            [[nodiscard]] auto get_width() const -> std::size_t;
+            [[nodiscard]] auto get_height() const -> std::size_t;
+
+            // Bit-identical to steps calls of simulate_step_with_biases() (simulate_step() without biases) on every model:
+            // get_old_state() holds the last state and get_new_state() the one before. The models need their states,
+            // the batch's size and width and height >= 3.
+            auto step(std::span<Model* const> models, const std::size_t& steps, const bool& biases) -> void;
+    };
+}
@@ -0,0 +1,109 @@
+#include "observation.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "kernels.h"
+
+namespace m964 {
+    namespace {
+        template<typename Pixel, typename Binarize>
+        auto load_rows(Layer& layer, const Pixel* bitmap, const std::size_t& width, const std::size_t& height, const std::size_t& stride, const float& on_value, const Binarize& binarize) -> void {
+            const auto columns = std::min(width, layer.get_width());
+            const auto rows = std::min(height, layer.get_height());
+
+            // Same shape and no row padding, one pass over the whole layer
+            if (width == layer.get_width() && height == layer.get_height() && stride == width) {
+                binarize(layer.data(), bitmap, on_value, layer.size());
+                return;
+            }
+
+            for (std::size_t y = 0; y < rows; ++y) {
+                auto row = layer.row(y);
+
+                binarize(row.data(), bitmap + y * stride, on_value, columns);
+                std::fill(row.begin() + static_cast<std::ptrdiff_t>(columns), row.end(), 0.0f);
+            }
+
+            for (std::size_t y = rows; y < layer.get_height(); ++y) {
+                auto row = layer.row(y);
+                std::fill(row.begin(), row.end(), 0.0f);
+            }
+        }
+    }
+
+    auto load_bitmap(Layer& layer, const std::uint8_t* bitmap, const std::size_t& width, const std::size_t& height, const std::size_t& stride, const float& on_value) -> void {
+        load_rows(layer, bitmap, width, height, stride, on_value, active_kernels().binarize_u8);
+    }
+
+    auto load_bitmap(Layer& layer, const std::int32_t* bitmap, const std::size_t& width, const std::size_t& height, const std::size_t& stride, const float& on_value) -> void {
+        load_rows(layer, bitmap, width, height, stride, on_value, active_kernels().binarize_i32);
+    }
+
+    ObservationTrajectory::ObservationTrajectory(const std::size_t& width, const std::size_t& height, const std::size_t& target_count)
+        : width(width), height(height), target_count(target_count) {
+
+    }
+
+    auto ObservationTrajectory::record(const Layer& frame, std::span<const float> frame_targets) -> void {
+        if (frame.get_width() != width || frame.get_height() != height)
+            throw std::invalid_argument("ObservationTrajectory::record: frame dimensions do not match");
+
+        if (frame_targets.size() != target_count)
+            throw std::invalid_argument("ObservationTrajectory::record: expected " + std::to_string(target_count) + " targets");
+
+        frames.insert(frames.end(), frame.data(), frame.data() + frame.size());
+        targets.insert(targets.end(), frame_targets.begin(), frame_targets.end());
+        ++recorded_frames;
+    }
+
+    auto ObservationTrajectory::clear() -> void {
+        frames.clear();
+        targets.clear();
+        recorded_frames = 0;
+    }
+
+    auto ObservationTrajectory::get_width() const -> std::size_t {
+        return width;
+    }
+
+    auto ObservationTrajectory::get_height() const -> std::size_t {
+        return height;
+    }
+
+    auto ObservationTrajectory::frame_count() const -> std::size_t {
+        return recorded_frames;
+    }
+
+    auto ObservationTrajectory::frame(const std::size_t& index) const -> std::span<const float> {
+        return std::span<const float>(frames.data() + index * width * height, width * height);
+    }
+
+    auto ObservationTrajectory::frame_targets(const std::size_t& index) const -> std::span<const float> {
+        return std::span<const float>(targets.data() + index * target_count, target_count);
+    }
+
+    auto ObservationTrajectory::load(const std::size_t& index, Layer& state) const -> void {
+        if (state.get_width() != width || state.get_height() != height)
+            throw std::invalid_argument("ObservationTrajectory::load: state dimensions do not match");
+
+        const auto values = frame(index);
+        std::copy(values.begin(), values.end(), state.data());
+    }
+
+    auto replay_trajectory(Model& model, const ObservationTrajectory& trajectory, const std::size_t& n_evolution_steps, const FrameCostCallback& frame_cost) -> float {
+        auto cost = 0.0f;
+
+        for (std::size_t i = 0; i < trajectory.frame_count(); ++i) {
+            trajectory.load(i, model.get_old_state());
+
+            for (std::size_t t = 0; t < n_evolution_steps; ++t)
+                model.simulate_step_with_biases();
+
+            cost += frame_cost(model.get_new_state(), trajectory.frame_targets(i));
+        }
+
+        return cost;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <span>
+#include <functional>
+
+#include "layer.h"
+#include "model.h"
+
+namespace m964 {
+    // Writes a row-major bitmap of width x height pixels into the layer, nonzero pixels become on_value and everything
+    // else 0. stride is the distance between bitmap rows in pixels. The bitmap is anchored at the top left corner,
+    // layer cells it does not cover are cleared and pixels outside the layer are ignored.
+    auto load_bitmap(Layer& layer, const std::uint8_t* bitmap, const std::size_t& width, const std::size_t& height, const std::size_t& stride, const float& on_value = 1.0f) -> void;
+    auto load_bitmap(Layer& layer, const std::int32_t* bitmap, const std::size_t& width, const std::size_t& height, const std::size_t& stride, const float& on_value = 1.0f) -> void;
+
+    // Screens stored as Pixel screen[height][width], like the example games
+    template<typename Pixel, std::size_t Height, std::size_t Width>
+    auto load_bitmap(Layer& layer, const Pixel (&screen)[Height][Width], const float& on_value = 1.0f) -> void {
+        load_bitmap(layer, &screen[0][0], Width, Height, Width, on_value);
+    }
+
+    // Teacher-forced episode: the observations and expected outputs of an environment that does not react to the
+    // model, recorded once and then replayed read-only by every candidate of the population
+    class ObservationTrajectory {
+        private:
+            std::size_t width;
+            std::size_t height;
+            std::size_t target_count;
+            std::size_t recorded_frames = 0;
+
+            std::vector<float> frames;  // row-major frames back to back
+            std::vector<float> targets; // target_count values per frame
+
+        public:
+            ObservationTrajectory(const std::size_t& width, const std::size_t& height, const std::size_t& target_count = 1);
+
+            auto record(const Layer& frame, std::span<const float> frame_targets) -> void;
+            auto clear() -> void;
+
+            [[nodiscard]] auto get_width() const -> std::size_t;
+            [[nodiscard]] auto get_height() const -> std::size_t;
+            [[nodiscard]] auto frame_count() const -> std::size_t;
+
+            [[nodiscard]] auto frame(const std::size_t& index) const -> std::span<const float>;
+            [[nodiscard]] auto frame_targets(const std::size_t& index) const -> std::span<const float>;
+
+            // Copies frame index into the state
+            auto load(const std::size_t& index, Layer& state) const -> void;
+    };
+
+    // Receives the state after the evolution steps of a frame and that frame's targets, returns the frame cost
+    using FrameCostCallback = std::function<float(const Layer&, std::span<const float>)>;
+
+    // For every frame: loads it into the old state, runs n_evolution_steps steps with biases and adds frame_cost
+    // of the new state. The cost only depends on the model, so all candidates can share one trajectory.
+    auto replay_trajectory(Model& model, const ObservationTrajectory& trajectory, const std::size_t& n_evolution_steps, const FrameCostCallback& frame_cost) -> float;
+}
\ No newline at end of file
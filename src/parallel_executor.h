@@ -27,6 +27,15 @@ class ParallelExecutor {
 
         template<typename RandomAccessIterator, typename Func>
         void execute(RandomAccessIterator first, RandomAccessIterator last, Func func) const {
+            execute_chunked(first, last, [func](const std::size_t&, auto&& element) {
+                func(element);
+            });
+        }
+
+        // Like execute, but func(chunk, element) also gets the index of the contiguous chunk the element belongs to.
+        // Every chunk runs on its own thread and chunk < get_num_threads(), so per-chunk state needs no locking.
+        template<typename RandomAccessIterator, typename Func>
+        void execute_chunked(RandomAccessIterator first, RandomAccessIterator last, Func func) const {
             const auto total_elements = std::distance(first, last);
 
             if (total_elements == 0)
@@ -45,9 +54,9 @@ class ParallelExecutor {
                 auto current_last = current_first;
                 std::advance(current_last, chunk_size + (i < remainder ? 1 : 0));
 
-                threads.emplace_back([current_first, current_last, func]() {
+                threads.emplace_back([current_first, current_last, func, chunk = std::size_t{ i }]() {
                     for (auto it = current_first; it != current_last; ++it) {
-                        func(*it);
+                        func(chunk, *it);
                     }
                 });
 
@@ -59,6 +68,10 @@ class ParallelExecutor {
                     thread.join();
         }
 
+        [[nodiscard]] auto get_num_threads() const -> std::size_t {
+            return num_threads;
+        }
+
     private:
         unsigned int num_threads;
 };
\ No newline at end of file
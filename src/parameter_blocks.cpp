@@ -0,0 +1,140 @@
+#include "parameter_blocks.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "utils.h"
+
+namespace m964 {
+    BlockParameters::BlockParameters(const Model& model, const std::size_t& block_size)
+        : width(model.width),
+          height(model.height),
+          block_size(std::max<std::size_t>(block_size, 1)),
+          blocks_x((model.width + this->block_size - 1) / this->block_size),
+          blocks_y((model.height + this->block_size - 1) / this->block_size) {
+        blocks.reserve(blocks_x * blocks_y);
+
+        for (std::size_t i = 0; i < blocks_x * blocks_y; ++i) {
+            const auto region = block_region(i);
+            auto block = std::make_shared<ParameterBlock>();
+
+            for (auto y = region.y_begin; y < region.y_end; ++y) {
+                for (auto x = region.x_begin; x < region.x_end; ++x) {
+                    block->biases.push_back(model.bias_layer(x, y));
+                    block->kernels.push_back(model.weights(x, y));
+                }
+            }
+
+            blocks.push_back(std::move(block));
+        }
+    }
+
+    auto BlockParameters::write_block(Model& model, const std::size_t& block) const -> void {
+        const auto region = block_region(block);
+        const auto tile_width = region.x_end - region.x_begin;
+        const auto& values = *blocks[block];
+
+        for (auto y = region.y_begin; y < region.y_end; ++y) {
+            const auto offset = (y - region.y_begin) * tile_width;
+
+            std::copy_n(values.biases.data() + offset, tile_width, model.bias_layer.data() + y * width + region.x_begin);
+            std::copy_n(values.kernels.data() + offset, tile_width, model.weights.data() + y * width + region.x_begin);
+        }
+    }
+
+    auto BlockParameters::get_width() const -> std::size_t {
+        return width;
+    }
+
+    auto BlockParameters::get_height() const -> std::size_t {
+        return height;
+    }
+
+    auto BlockParameters::block_count() const -> std::size_t {
+        return blocks.size();
+    }
+
+    auto BlockParameters::block_region(const std::size_t& block) const -> CellRegion {
+        const auto x_begin = (block % blocks_x) * block_size;
+        const auto y_begin = (block / blocks_x) * block_size;
+
+        return CellRegion { x_begin, std::min(width, x_begin + block_size), y_begin, std::min(height, y_begin + block_size) };
+    }
+
+    auto BlockParameters::get_block(const std::size_t& block) const -> const ParameterBlock& {
+        return *blocks.at(block);
+    }
+
+    auto BlockParameters::mutable_block(const std::size_t& block) -> ParameterBlock& {
+        auto& shared = blocks.at(block);
+
+        if (shared.use_count() > 1)
+            shared = std::make_shared<ParameterBlock>(*shared);
+
+        return *shared;
+    }
+
+    auto BlockParameters::mutate_block(const std::size_t& block, const float& mutation_strength) -> void {
+        const auto region = block_region(block);
+        const auto tile_width = region.x_end - region.x_begin;
+
+        auto& values = mutable_block(block);
+
+        for (auto x = region.x_begin; x < region.x_end; ++x)
+            for (auto y = region.y_begin; y < region.y_end; ++y)
+                values.biases[(x - region.x_begin) + (y - region.y_begin) * tile_width] += rand_float(-1.0f, 1.0f) * mutation_strength;
+
+        for (auto x = region.x_begin; x < region.x_end; ++x)
+            for (auto y = region.y_begin; y < region.y_end; ++y)
+                for (std::size_t j = 0; j < 9; ++j)
+                    values.kernels[(x - region.x_begin) + (y - region.y_begin) * tile_width].values[j] += rand_float(-mutation_strength, mutation_strength);
+    }
+
+    auto BlockParameters::mutate_random_block(const float& mutation_strength) -> CellRegion {
+        const auto block = static_cast<std::size_t>(rand_int(0, static_cast<int>(blocks.size()) - 1));
+        mutate_block(block, mutation_strength);
+
+        return block_region(block);
+    }
+
+    auto BlockParameters::write_to(Model& model) const -> void {
+        if (model.width != width || model.height != height)
+            throw std::invalid_argument("BlockParameters::write_to: model dimensions do not match");
+
+        for (std::size_t i = 0; i < blocks.size(); ++i)
+            write_block(model, i);
+    }
+
+    auto BlockParameters::write_changed_to(Model& model, const BlockParameters& current) const -> std::size_t {
+        if (model.width != width || model.height != height || current.width != width || current.height != height || current.block_size != block_size)
+            throw std::invalid_argument("BlockParameters::write_changed_to: dimensions or block sizes do not match");
+
+        auto written = std::size_t{ 0 };
+
+        for (std::size_t i = 0; i < blocks.size(); ++i) {
+            if (blocks[i] == current.blocks[i])
+                continue;
+
+            write_block(model, i);
+            ++written;
+        }
+
+        return written;
+    }
+
+    auto BlockParameters::owned_block_count() const -> std::size_t {
+        return static_cast<std::size_t>(std::count_if(blocks.begin(), blocks.end(), [](const auto& block) {
+            return block.use_count() == 1;
+        }));
+    }
+
+    auto BlockParameters::owned_bytes() const -> std::size_t {
+        auto bytes = std::size_t{ 0 };
+
+        for (const auto& block : blocks)
+            if (block.use_count() == 1)
+                bytes += block->biases.size() * sizeof(float) + block->kernels.size() * sizeof(Kernel);
+
+        return bytes;
+    }
+}
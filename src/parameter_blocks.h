@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "kernel.h"
+#include "model.h"
+#include "light_cone.h"
+
+namespace m964 {
+    constexpr std::size_t DEFAULT_PARAMETER_BLOCK_SIZE = 16;
+
+    // Biases and kernels of one tile of cells, row-major within the tile
+    struct ParameterBlock {
+        std::vector<float> biases;
+        std::vector<Kernel> kernels;
+    };
+
+    // Copy-on-write parameters of a Model, partitioned into block_size x block_size tiles. Copies share all blocks,
+    // a block is only cloned when a copy mutates it, so a candidate costs one pointer per block plus the blocks it changed.
+    // Shared blocks are never written, copies may be read from several threads but each copy is mutated by one thread only.
+    class BlockParameters {
+        private:
+            std::size_t width;
+            std::size_t height;
+            std::size_t block_size;
+            std::size_t blocks_x;
+            std::size_t blocks_y;
+
+            std::vector<std::shared_ptr<ParameterBlock>> blocks;
+
+            auto write_block(Model& model, const std::size_t& block) const -> void;
+
+        public:
+            explicit BlockParameters(const Model& model, const std::size_t& block_size = DEFAULT_PARAMETER_BLOCK_SIZE);
+
+            [[nodiscard]] auto get_width() const -> std::size_t;
+            [[nodiscard]] auto get_height() const -> std::size_t;
+            [[nodiscard]] auto block_count() const -> std::size_t;
+            [[nodiscard]] auto block_region(const std::size_t& block) const -> CellRegion;
+
+            [[nodiscard]] auto get_block(const std::size_t& block) const -> const ParameterBlock&;
+
+            // Clones the block first if another copy still shares it
+            auto mutable_block(const std::size_t& block) -> ParameterBlock&;
+
+            // mutate_model on one block, with the same noise and the same column-major draw order within the tile
+            auto mutate_block(const std::size_t& block, const float& mutation_strength) -> void;
+
+            // Mutates a random block and returns its cells, e.g. for IncrementalEvaluator::evaluate
+            auto mutate_random_block(const float& mutation_strength) -> CellRegion;
+
+            // Writes all parameters into the model
+            auto write_to(Model& model) const -> void;
+
+            // Writes only the blocks that are not shared with current, the parameters the model holds right now
+            auto write_changed_to(Model& model, const BlockParameters& current) const -> std::size_t;
+
+            // Blocks no other copy refers to, the memory this copy adds on top of the ones it shares with
+            [[nodiscard]] auto owned_block_count() const -> std::size_t;
+            [[nodiscard]] auto owned_bytes() const -> std::size_t;
+    };
+}
@@ -0,0 +1,278 @@
+#include "perf_counters.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+namespace m964 {
+    namespace {
+        auto environment_enabled() -> bool {
+            const auto* value = std::getenv("PERF_COUNTERS");
+            return value != nullptr && std::strcmp(value, "0") != 0;
+        }
+
+        std::atomic<bool> counters_enabled{ environment_enabled() };
+
+        auto steady_seconds() -> double {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        auto difference(const PerfSample& end, const PerfSample& start) -> PerfSample {
+            auto sample = PerfSample{};
+            sample.calls = 1;
+            sample.seconds = end.seconds - start.seconds;
+            sample.hardware = end.hardware;
+            sample.cycles = end.cycles - start.cycles;
+            sample.instructions = end.instructions - start.instructions;
+            sample.l1d_misses = end.l1d_misses - start.l1d_misses;
+            sample.llc_misses = end.llc_misses - start.llc_misses;
+            sample.branch_misses = end.branch_misses - start.branch_misses;
+            return sample;
+        }
+
+        // One counter group per thread, running from the first scope until the thread exits
+        struct ThreadPerfState {
+            PerfCounterGroup group;
+            std::vector<PerfSample> open_scopes;
+
+            std::mutex mutex;
+            std::array<PerfSample, PERF_REGION_COUNT> totals{};
+
+            ThreadPerfState();
+            ~ThreadPerfState();
+        };
+
+        std::mutex registry_mutex;
+        std::vector<ThreadPerfState*> live_threads;
+        std::array<PerfSample, PERF_REGION_COUNT> exited_thread_totals{};
+
+        ThreadPerfState::ThreadPerfState() {
+            std::lock_guard<std::mutex> lock(registry_mutex);
+            live_threads.push_back(this);
+        }
+
+        ThreadPerfState::~ThreadPerfState() {
+            std::lock_guard<std::mutex> lock(registry_mutex);
+            live_threads.erase(std::remove(live_threads.begin(), live_threads.end(), this), live_threads.end());
+
+            for (std::size_t i = 0; i < PERF_REGION_COUNT; ++i)
+                exited_thread_totals[i] += totals[i];
+        }
+
+        auto thread_perf_state() -> ThreadPerfState& {
+            thread_local ThreadPerfState state;
+            return state;
+        }
+
+#if defined(__linux__)
+        auto open_counter(const std::uint32_t& type, const std::uint64_t& config, const int& group) -> int {
+            auto attributes = perf_event_attr{};
+            attributes.size = sizeof(attributes);
+            attributes.type = type;
+            attributes.config = config;
+            attributes.disabled = group < 0 ? 1 : 0;
+            attributes.exclude_kernel = 1;
+            attributes.exclude_hv = 1;
+            attributes.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            // pid 0, cpu -1: the calling thread on any CPU
+            return static_cast<int>(::syscall(SYS_perf_event_open, &attributes, 0, -1, group, 0));
+        }
+#endif
+    }
+
+    auto perf_region_name(const PerfRegion& region) -> const char* {
+        switch (region) {
+            case PerfRegion::Step: return "step";
+            case PerfRegion::Loss: return "loss";
+            case PerfRegion::Evaluation: return "evaluation";
+            case PerfRegion::Mutation: return "mutation";
+            case PerfRegion::Count: break;
+        }
+
+        return "unknown";
+    }
+
+    auto PerfSample::ipc() const -> double {
+        return cycles > 0 ? static_cast<double>(instructions) / static_cast<double>(cycles) : 0.0;
+    }
+
+    auto PerfSample::operator+=(const PerfSample& other) -> PerfSample& {
+        calls += other.calls;
+        seconds += other.seconds;
+        hardware = hardware || other.hardware;
+        cycles += other.cycles;
+        instructions += other.instructions;
+        l1d_misses += other.l1d_misses;
+        llc_misses += other.llc_misses;
+        branch_misses += other.branch_misses;
+        return *this;
+    }
+
+    auto to_json(const PerfSample& sample) -> std::string {
+        char buffer[384];
+
+        if (!sample.hardware) {
+            std::snprintf(buffer, sizeof(buffer), "{\"calls\":%llu,\"seconds\":%.9g,\"hardware\":false}",
+                static_cast<unsigned long long>(sample.calls), sample.seconds);
+            return buffer;
+        }
+
+        std::snprintf(buffer, sizeof(buffer),
+            "{\"calls\":%llu,\"seconds\":%.9g,\"hardware\":true,\"cycles\":%llu,\"instructions\":%llu,\"ipc\":%.4f,\"l1d_misses\":%llu,\"llc_misses\":%llu,\"branch_misses\":%llu}",
+            static_cast<unsigned long long>(sample.calls), sample.seconds,
+            static_cast<unsigned long long>(sample.cycles), static_cast<unsigned long long>(sample.instructions), sample.ipc(),
+            static_cast<unsigned long long>(sample.l1d_misses), static_cast<unsigned long long>(sample.llc_misses),
+            static_cast<unsigned long long>(sample.branch_misses));
+
+        return buffer;
+    }
+
+    PerfCounterGroup::PerfCounterGroup() : leader(-1), descriptors{}, fields{}, counter_count(0) {
+#if defined(__linux__)
+        struct CounterConfig {
+            std::uint32_t type;
+            std::uint64_t config;
+            std::uint64_t PerfSample::* field;
+        };
+
+        const CounterConfig counters[] = {
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, &PerfSample::cycles },
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, &PerfSample::instructions },
+            { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16), &PerfSample::l1d_misses },
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, &PerfSample::llc_misses },
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, &PerfSample::branch_misses }
+        };
+
+        // The first counter that opens leads the group, unsupported ones are skipped
+        for (const auto& counter : counters) {
+            const auto descriptor = open_counter(counter.type, counter.config, leader);
+            if (descriptor < 0)
+                continue;
+
+            if (leader < 0)
+                leader = descriptor;
+
+            descriptors[counter_count] = descriptor;
+            fields[counter_count] = counter.field;
+            ++counter_count;
+        }
+
+        if (leader >= 0) {
+            ::ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ::ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+
+        start_sample = snapshot();
+    }
+
+    PerfCounterGroup::~PerfCounterGroup() {
+#if defined(__linux__)
+        for (std::size_t i = 0; i < counter_count; ++i)
+            ::close(descriptors[i]);
+#endif
+    }
+
+    auto PerfCounterGroup::available() const -> bool {
+        return leader >= 0;
+    }
+
+    auto PerfCounterGroup::snapshot() const -> PerfSample {
+        auto sample = PerfSample{};
+        sample.seconds = steady_seconds();
+
+#if defined(__linux__)
+        if (leader < 0)
+            return sample;
+
+        // nr, time_enabled, time_running, values[nr]
+        std::uint64_t buffer[3 + 5] = {};
+        if (::read(leader, buffer, sizeof(buffer)) < static_cast<ssize_t>((3 + counter_count) * sizeof(std::uint64_t)))
+            return sample;
+
+        // Scale up if the kernel had to multiplex the counters
+        const auto enabled = buffer[1];
+        const auto running = buffer[2];
+        const auto scale = running > 0 && running < enabled ? static_cast<double>(enabled) / static_cast<double>(running) : 1.0;
+
+        for (std::size_t i = 0; i < counter_count && i < buffer[0]; ++i)
+            sample.*fields[i] = static_cast<std::uint64_t>(static_cast<double>(buffer[3 + i]) * scale);
+
+        sample.hardware = true;
+#endif
+
+        return sample;
+    }
+
+    auto PerfCounterGroup::start() -> void {
+        start_sample = snapshot();
+    }
+
+    auto PerfCounterGroup::stop() -> PerfSample {
+        return difference(snapshot(), start_sample);
+    }
+
+    auto set_perf_counters_enabled(const bool& enabled) -> void {
+        counters_enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    auto perf_counters_enabled() -> bool {
+        return counters_enabled.load(std::memory_order_relaxed);
+    }
+
+    auto collect_perf_regions() -> std::array<PerfSample, PERF_REGION_COUNT> {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        auto totals = exited_thread_totals;
+
+        for (auto* thread : live_threads) {
+            std::lock_guard<std::mutex> thread_lock(thread->mutex);
+            for (std::size_t i = 0; i < PERF_REGION_COUNT; ++i)
+                totals[i] += thread->totals[i];
+        }
+
+        return totals;
+    }
+
+    auto reset_perf_regions() -> void {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        exited_thread_totals = {};
+
+        for (auto* thread : live_threads) {
+            std::lock_guard<std::mutex> thread_lock(thread->mutex);
+            thread->totals = {};
+        }
+    }
+
+    PerfScope::PerfScope(const PerfRegion& region) : region(region), active(perf_counters_enabled()) {
+        if (!active)
+            return;
+
+        auto& state = thread_perf_state();
+        state.open_scopes.push_back(state.group.snapshot());
+    }
+
+    PerfScope::~PerfScope() {
+        if (!active)
+            return;
+
+        auto& state = thread_perf_state();
+        const auto sample = difference(state.group.snapshot(), state.open_scopes.back());
+        state.open_scopes.pop_back();
+
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.totals[static_cast<std::size_t>(region)] += sample;
+    }
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <string>
+
+namespace m964 {
+    // Regions are inclusive: an Evaluation contains the Steps and Loss computations of its cost callback
+    enum class PerfRegion {
+        Step,       // Model::simulate_step, Model::simulate_step_with_biases
+        Loss,       // simulate_step_with_loss and the loss functions
+        Evaluation, // one cost callback invocation during training
+        Mutation,   // mutating the population of an epoch
+        Count
+    };
+
+    constexpr std::size_t PERF_REGION_COUNT = static_cast<std::size_t>(PerfRegion::Count);
+
+    auto perf_region_name(const PerfRegion& region) -> const char*;
+
+    struct PerfSample {
+        std::uint64_t calls = 0;
+        double seconds = 0.0;
+
+        bool hardware = false; // false if perf_event_open is unavailable, only calls and seconds are valid
+        std::uint64_t cycles = 0;
+        std::uint64_t instructions = 0;
+        std::uint64_t l1d_misses = 0;
+        std::uint64_t llc_misses = 0;
+        std::uint64_t branch_misses = 0;
+
+        [[nodiscard]] auto ipc() const -> double;
+        auto operator+=(const PerfSample& other) -> PerfSample&;
+    };
+
+    auto to_json(const PerfSample& sample) -> std::string;
+
+    // Hardware counters of the calling thread (cycles, instructions, L1D and LLC misses, branch misses)
+    // read as one perf_event_open group. Counters that cannot be opened stay zero.
+    class PerfCounterGroup {
+        private:
+            int leader;
+            std::array<int, 5> descriptors;
+            std::array<std::uint64_t PerfSample::*, 5> fields;
+            std::size_t counter_count;
+
+            PerfSample start_sample;
+
+        public:
+            PerfCounterGroup();
+            ~PerfCounterGroup();
+
+            PerfCounterGroup(const PerfCounterGroup&) = delete;
+            auto operator=(const PerfCounterGroup&) -> PerfCounterGroup& = delete;
+
+            [[nodiscard]] auto available() const -> bool;
+
+            // Counter values accumulated since construction, seconds is the current steady clock time
+            [[nodiscard]] auto snapshot() const -> PerfSample;
+
+            auto start() -> void;
+            auto stop() -> PerfSample;
+    };
+
+    // Scoped regions are off by default and then cost a single relaxed atomic load.
+    // PERF_COUNTERS=1 in the environment enables them at startup.
+    auto set_perf_counters_enabled(const bool& enabled) -> void;
+    [[nodiscard]] auto perf_counters_enabled() -> bool;
+
+    // Totals of all threads since the last reset, including threads that have exited
+    auto collect_perf_regions() -> std::array<PerfSample, PERF_REGION_COUNT>;
+    auto reset_perf_regions() -> void;
+
+    class PerfScope {
+        private:
+            PerfRegion region;
+            bool active;
+
+        public:
+            explicit PerfScope(const PerfRegion& region);
+            ~PerfScope();
+
+            PerfScope(const PerfScope&) = delete;
+            auto operator=(const PerfScope&) -> PerfScope& = delete;
+    };
+}
@@ -0,0 +1,39 @@
+#include "scratch.h"
+
+namespace m964 {
+    SimulationScratch::SimulationScratch(const std::size_t& width, const std::size_t& height) : width(width), height(height) {
+        buffers.emplace_back(width, height);
+        buffers.emplace_back(width, height);
+    }
+
+    auto SimulationScratch::get_width() const -> std::size_t {
+        return width;
+    }
+
+    auto SimulationScratch::get_height() const -> std::size_t {
+        return height;
+    }
+
+    auto SimulationScratch::lend(Model& model) -> bool {
+        if (model.has_states() || buffers.size() != 2 || model.width != width || model.height != height)
+            return false;
+
+        model.adopt_states(std::move(buffers));
+        buffers.clear();
+
+        return true;
+    }
+
+    auto SimulationScratch::reclaim(Model& model) -> void {
+        buffers = model.release_states();
+    }
+
+    ScratchLease::ScratchLease(Model& model, SimulationScratch& scratch) : model(model), scratch(scratch), lent(scratch.lend(model)) {
+
+    }
+
+    ScratchLease::~ScratchLease() {
+        if (lent)
+            scratch.reclaim(model);
+    }
+}
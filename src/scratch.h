@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "layer.h"
+#include "model.h"
+
+namespace m964 {
+    // Ping-pong buffers of one worker. Candidates are kept without states (Model::release_states()) and borrow these
+    // while they are evaluated, so a population needs buffers per worker instead of per candidate.
+    class SimulationScratch {
+        private:
+            std::size_t width;
+            std::size_t height;
+            std::vector<Layer> buffers;
+
+        public:
+            SimulationScratch(const std::size_t& width, const std::size_t& height);
+
+            [[nodiscard]] auto get_width() const -> std::size_t;
+            [[nodiscard]] auto get_height() const -> std::size_t;
+
+            // Lends the buffers to a model without states, returns false if the model already has its own or they are lent
+            auto lend(Model& model) -> bool;
+            auto reclaim(Model& model) -> void;
+    };
+
+    // Lends the scratch to the model for the lifetime of the lease, a model that has its own states keeps them
+    class ScratchLease {
+        private:
+            Model& model;
+            SimulationScratch& scratch;
+            bool lent;
+
+        public:
+            ScratchLease(Model& model, SimulationScratch& scratch);
+            ~ScratchLease();
+
+            ScratchLease(const ScratchLease&) = delete;
+            auto operator=(const ScratchLease&) -> ScratchLease& = delete;
+    };
+}
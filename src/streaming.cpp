@@ -0,0 +1,63 @@
+#include "streaming.h"
+
+#include <stdexcept>
+
+namespace m964 {
+    namespace {
+        auto inject(float& value, const float& observation, const InjectionPolicy& policy, const float& blend_factor) -> void {
+            if (policy == InjectionPolicy::Replace)
+                value = observation;
+            else
+                value += blend_factor * (observation - value);
+        }
+    }
+
+    StreamingController::StreamingController(StreamingParameters parameters) : parameters(std::move(parameters)) {
+
+    }
+
+    auto StreamingController::reset(Model& model) -> void {
+        model.reset_states();
+        frames = 0;
+    }
+
+    auto StreamingController::step(Model& model, const Layer& observation) -> Layer& {
+        auto& state = model.get_old_state();
+
+        if (observation.get_width() != state.get_width() || observation.get_height() != state.get_height())
+            throw std::invalid_argument("StreamingController::step: observation dimensions do not match the model");
+
+        auto* values = state.data();
+        const auto* observed = observation.data();
+
+        if (parameters.input_cells.empty()) {
+            for (std::size_t i = 0; i < state.size(); ++i)
+                inject(values[i], observed[i], parameters.policy, parameters.blend_factor);
+        } else {
+            for (const auto& cell : parameters.input_cells)
+                if (cell < state.size())
+                    inject(values[cell], observed[cell], parameters.policy, parameters.blend_factor);
+        }
+
+        const auto steps = frames == 0 ? parameters.warmup_steps : parameters.steps_per_frame;
+
+        for (std::size_t t = 0; t < steps; ++t) {
+            if (parameters.biases)
+                model.simulate_step_with_biases();
+            else
+                model.simulate_step();
+        }
+
+        ++frames;
+
+        return model.get_old_state();
+    }
+
+    auto StreamingController::get_parameters() const -> const StreamingParameters& {
+        return parameters;
+    }
+
+    auto StreamingController::get_frames() const -> std::size_t {
+        return frames;
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "layer.h"
+#include "model.h"
+
+namespace m964 {
+    enum class InjectionPolicy {
+        Replace, // input cells take the observation value
+        Blend    // input cells move blend_factor of the way towards the observation
+    };
+
+    struct StreamingParameters {
+        std::size_t steps_per_frame = 4;
+        std::size_t warmup_steps = 24; // steps of the first frame after reset(), when there is no state to carry over yet
+
+        InjectionPolicy policy = InjectionPolicy::Replace;
+        float blend_factor = 0.5f;
+
+        // x + y * width of the cells that receive the observation, empty injects into every cell
+        std::vector<std::size_t> input_cells = {};
+
+        bool biases = true; // simulate_step_with_biases() or simulate_step()
+    };
+
+    // Recurrent control: the model state carries over from frame to frame, every frame only injects the new observation
+    // into the input cells and runs a few steps instead of resetting the state and running the whole rollout again.
+    class StreamingController {
+        private:
+            StreamingParameters parameters;
+            std::size_t frames = 0;
+
+        public:
+            explicit StreamingController(StreamingParameters parameters);
+
+            // Clears the model state, call at the start of every episode
+            auto reset(Model& model) -> void;
+
+            // Injects the observation and advances the model, returns the state after the last step
+            auto step(Model& model, const Layer& observation) -> Layer&;
+
+            [[nodiscard]] auto get_parameters() const -> const StreamingParameters&;
+            [[nodiscard]] auto get_frames() const -> std::size_t;
+    };
+}
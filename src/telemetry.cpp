@@ -0,0 +1,115 @@
+#include "telemetry.h"
+
+#include <cmath>
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+#include <iostream>
+
+namespace m964 {
+    auto LatencyHistogram::add(const double& seconds) -> void {
+        const auto microseconds = seconds * 1e6;
+
+        auto bucket = std::size_t{0};
+        if (microseconds >= 2.0)
+            bucket = std::min(static_cast<std::size_t>(std::log2(microseconds)), BUCKET_COUNT - 1);
+
+        ++counts[bucket];
+        ++total;
+    }
+
+    auto LatencyHistogram::quantile(const double& q) const -> double {
+        if (total == 0)
+            return 0.0;
+
+        const auto rank = static_cast<std::uint64_t>(std::ceil(q * static_cast<double>(total)));
+        auto seen = std::uint64_t{0};
+
+        for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+            seen += counts[i];
+            if (seen >= rank && seen > 0)
+                return std::ldexp(1.0, static_cast<int>(i) + 1) * 1e-6;
+        }
+
+        return std::ldexp(1.0, static_cast<int>(BUCKET_COUNT)) * 1e-6;
+    }
+
+    auto to_json(const EpochTelemetry& telemetry) -> std::string {
+        auto stream = std::ostringstream{};
+        char buffer[256];
+
+        std::snprintf(buffer, sizeof(buffer), "{\"epoch\":%lld,\"generation\":%lld,\"best_cost\":%.9g,\"mutation_strength\":%.9g,\"improved\":%s,",
+            telemetry.epoch, telemetry.generation, telemetry.best_cost, telemetry.mutation_strength, telemetry.improved ? "true" : "false");
+        stream << buffer;
+
+        std::snprintf(buffer, sizeof(buffer), "\"evaluations\":%zu,\"aborted_evaluations\":%zu,\"screening_evaluations\":%zu,",
+            telemetry.evaluations, telemetry.aborted_evaluations, telemetry.screening_evaluations);
+        stream << buffer;
+
+        std::snprintf(buffer, sizeof(buffer), "\"epoch_seconds\":%.9g,\"mutation_seconds\":%.9g,\"screening_seconds\":%.9g,\"evaluation_seconds\":%.9g,\"lock_wait_seconds\":%.9g,\"reduction_seconds\":%.9g,",
+            telemetry.epoch_seconds, telemetry.mutation_seconds, telemetry.screening_seconds, telemetry.evaluation_seconds, telemetry.lock_wait_seconds, telemetry.reduction_seconds);
+        stream << buffer;
+
+        std::snprintf(buffer, sizeof(buffer), "\"evaluations_per_second\":%.9g,\"cells_per_second\":%.9g,",
+            telemetry.evaluations_per_second, telemetry.cells_per_second);
+        stream << buffer;
+
+        stream << "\"threads\":[";
+        for (std::size_t i = 0; i < telemetry.threads.size(); ++i) {
+            const auto& thread = telemetry.threads[i];
+            std::snprintf(buffer, sizeof(buffer), "%s{\"evaluations\":%zu,\"busy_seconds\":%.9g,\"utilization\":%.4f}",
+                i > 0 ? "," : "", thread.evaluations, thread.busy_seconds, thread.utilization);
+            stream << buffer;
+        }
+
+        // Trailing empty buckets are left out
+        auto last_bucket = LatencyHistogram::BUCKET_COUNT;
+        while (last_bucket > 0 && telemetry.latency.counts[last_bucket - 1] == 0)
+            --last_bucket;
+
+        stream << "],\"latency_us_log2_buckets\":[";
+        for (std::size_t i = 0; i < last_bucket; ++i)
+            stream << (i > 0 ? "," : "") << telemetry.latency.counts[i];
+
+        std::snprintf(buffer, sizeof(buffer), "],\"latency_p50_seconds\":%.9g,\"latency_p90_seconds\":%.9g,\"latency_p99_seconds\":%.9g",
+            telemetry.latency.quantile(0.5), telemetry.latency.quantile(0.9), telemetry.latency.quantile(0.99));
+        stream << buffer;
+
+        if (telemetry.perf_counters) {
+            stream << ",\"regions\":{";
+
+            for (std::size_t i = 0; i < PERF_REGION_COUNT; ++i)
+                stream << (i > 0 ? "," : "") << "\"" << perf_region_name(static_cast<PerfRegion>(i)) << "\":" << to_json(telemetry.regions[i]);
+
+            stream << "}";
+        }
+
+        stream << "}";
+
+        return stream.str();
+    }
+
+    JsonLinesTelemetrySink::JsonLinesTelemetrySink(const std::string& file_name) : stream(file_name, std::ios::app) {
+        if (!stream)
+            std::cerr << "Error [JsonLinesTelemetrySink]: Could not open " << file_name << " for writing." << std::endl;
+    }
+
+    auto JsonLinesTelemetrySink::is_open() const -> bool {
+        return stream.is_open() && stream.good();
+    }
+
+    auto JsonLinesTelemetrySink::emit(const EpochTelemetry& telemetry) -> void {
+        const auto line = to_json(telemetry);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        stream << line << '\n';
+        stream.flush();
+    }
+
+    CallbackTelemetrySink::CallbackTelemetrySink(std::function<void(const EpochTelemetry&)> callback) : callback(std::move(callback)) {}
+
+    auto CallbackTelemetrySink::emit(const EpochTelemetry& telemetry) -> void {
+        if (callback)
+            callback(telemetry);
+    }
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <mutex>
+#include <functional>
+
+#include "perf_counters.h"
+
+namespace m964 {
+    // Candidate evaluation latencies in power-of-two microsecond buckets, bucket i holds [2^i, 2^(i+1)) us
+    struct LatencyHistogram {
+        static constexpr std::size_t BUCKET_COUNT = 32;
+
+        std::array<std::uint64_t, BUCKET_COUNT> counts{};
+        std::uint64_t total = 0;
+
+        auto add(const double& seconds) -> void;
+
+        // Upper bound of the bucket that contains the given quantile, in seconds
+        [[nodiscard]] auto quantile(const double& q) const -> double;
+    };
+
+    struct ThreadTelemetry {
+        std::size_t evaluations = 0;
+        double busy_seconds = 0.0;
+        double utilization = 0.0; // busy_seconds / evaluation_seconds of the epoch
+    };
+
+    struct EpochTelemetry {
+        long long epoch = 0;
+        long long generation = 0;
+        float best_cost = 0.0f;
+        float mutation_strength = 0.0f;
+        bool improved = false;
+
+        std::size_t evaluations = 0;
+        std::size_t aborted_evaluations = 0;
+        std::size_t screening_evaluations = 0; // cheap successive halving evaluations before the full ones
+
+        double epoch_seconds = 0.0;
+        double mutation_seconds = 0.0;    // summed over all threads in steady-state mode
+        double screening_seconds = 0.0;
+        double evaluation_seconds = 0.0;  // wall time of the parallel evaluation phase
+        double lock_wait_seconds = 0.0;   // summed over all threads
+        double reduction_seconds = 0.0;   // time spent holding the best model lock, summed over all threads
+
+        double evaluations_per_second = 0.0;
+        double cells_per_second = 0.0;    // nominal, assumes n_evolution_steps steps of the full grid per evaluation
+
+        std::vector<ThreadTelemetry> threads;
+        LatencyHistogram latency;
+
+        // Per-region counters of this epoch, only filled while perf counters are enabled
+        bool perf_counters = false;
+        std::array<PerfSample, PERF_REGION_COUNT> regions{};
+    };
+
+    auto to_json(const EpochTelemetry& telemetry) -> std::string;
+
+    class TelemetrySink {
+        public:
+            virtual ~TelemetrySink() = default;
+
+            virtual auto emit(const EpochTelemetry& telemetry) -> void = 0;
+    };
+
+    // One JSON object per epoch and line
+    class JsonLinesTelemetrySink : public TelemetrySink {
+        private:
+            std::ofstream stream;
+            std::mutex mutex;
+
+        public:
+            explicit JsonLinesTelemetrySink(const std::string& file_name);
+
+            [[nodiscard]] auto is_open() const -> bool;
+
+            auto emit(const EpochTelemetry& telemetry) -> void override;
+    };
+
+    class CallbackTelemetrySink : public TelemetrySink {
+        private:
+            std::function<void(const EpochTelemetry&)> callback;
+
+        public:
+            explicit CallbackTelemetrySink(std::function<void(const EpochTelemetry&)> callback);
+
+            auto emit(const EpochTelemetry& telemetry) -> void override;
+    };
+}
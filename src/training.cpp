@@ -50,7 +50,206 @@ namespace m964 {
         return new_average;
     }
 
+    auto initialize_model(Model& model, const float& initial_mutation_strength) -> void {
+        model.bias_layer.fill([&]() { // Assuming rand_float can be used here effectively
+            return rand_float(-initial_mutation_strength, initial_mutation_strength); // Example: smaller initial weight range
+        });
+
+        model.weights.fill([&]() { // Assuming rand_float can be used here effectively
+            return Kernel().fill(rand_float(-initial_mutation_strength, initial_mutation_strength)); // Example: smaller initial weight range
+        });
+    }
+
+    auto mutate_model(Model& model, const float& mutation_strength) -> void {
+        const auto width = model.width;
+        const auto height = model.height;
+        const auto bias_count = width * height;
+        const auto values = model.parameters();
+
+        // The noise is drawn in the same column-major order as Layer::apply and KernelOffset,
+        // so seeded runs stay reproducible, then added to the parameter buffer in one vectorized pass
+        thread_local std::vector<float> noise;
+        noise.resize(values.size());
+
+        for (std::size_t x = 0; x < width; ++x)
+            for (std::size_t y = 0; y < height; ++y)
+                noise[x + y * width] = rand_float(-1.0f, 1.0f) * mutation_strength;
+
+        for (std::size_t x = 0; x < width; ++x)
+            for (std::size_t y = 0; y < height; ++y)
+                for (std::size_t j = 0; j < 9; ++j)
+                    noise[bias_count + (x + y * width) * 9 + j] = rand_float(-mutation_strength, mutation_strength);
+
+        active_kernels().add(values.data(), noise.data(), values.size());
+    }
+
+    auto mutate_model_tile(Model& model, const float& mutation_strength, const std::size_t& tile_width, const std::size_t& tile_height) -> CellRegion {
+        const auto width = model.bias_layer.get_width();
+        const auto height = model.bias_layer.get_height();
+
+        const auto tile_w = std::clamp<std::size_t>(tile_width, 1, width);
+        const auto tile_h = std::clamp<std::size_t>(tile_height, 1, height);
+
+        const auto x_begin = static_cast<std::size_t>(rand_int(0, static_cast<int>(width - tile_w)));
+        const auto y_begin = static_cast<std::size_t>(rand_int(0, static_cast<int>(height - tile_h)));
+        const auto tile = CellRegion { x_begin, x_begin + tile_w, y_begin, y_begin + tile_h };
+
+        // Same column-major draw order as mutate_model, restricted to the tile
+        for (auto x = tile.x_begin; x < tile.x_end; ++x)
+            for (auto y = tile.y_begin; y < tile.y_end; ++y)
+                model.bias_layer(x, y) += rand_float(-1.0f, 1.0f) * mutation_strength;
+
+        for (auto x = tile.x_begin; x < tile.x_end; ++x)
+            for (auto y = tile.y_begin; y < tile.y_end; ++y)
+                for (std::size_t j = 0; j < 9; ++j)
+                    model.weights(x, y).values[j] += rand_float(-mutation_strength, mutation_strength);
+
+        return tile;
+    }
+
+    namespace {
+        struct CandidateTiming {
+            std::thread::id thread;
+            double latency_seconds = 0.0;
+            double lock_wait_seconds = 0.0;
+            double reduction_seconds = 0.0;
+        };
+
+        auto seconds_since(const std::chrono::high_resolution_clock::time_point& start_time) -> double {
+            return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start_time).count();
+        }
+
+        // Groups the candidate timings of one epoch by the thread that evaluated them
+        auto summarize_epoch(
+            const std::vector<CandidateTiming>& timings,
+            const std::chrono::high_resolution_clock::time_point& evaluation_start_time,
+            const std::chrono::high_resolution_clock::time_point& evaluation_end_time
+        ) -> EpochTelemetry {
+            auto telemetry = EpochTelemetry{};
+            telemetry.evaluations = timings.size();
+            telemetry.evaluation_seconds = std::chrono::duration<double>(evaluation_end_time - evaluation_start_time).count();
+            telemetry.evaluations_per_second = telemetry.evaluation_seconds > 0.0 ? static_cast<double>(timings.size()) / telemetry.evaluation_seconds : 0.0;
+
+            auto thread_ids = std::vector<std::thread::id>{};
+
+            for (const auto& timing : timings) {
+                telemetry.latency.add(timing.latency_seconds);
+                telemetry.lock_wait_seconds += timing.lock_wait_seconds;
+                telemetry.reduction_seconds += timing.reduction_seconds;
+
+                auto it = std::find(thread_ids.begin(), thread_ids.end(), timing.thread);
+                if (it == thread_ids.end()) {
+                    thread_ids.push_back(timing.thread);
+                    telemetry.threads.emplace_back();
+                    it = thread_ids.end() - 1;
+                }
+
+                auto& thread = telemetry.threads[static_cast<std::size_t>(it - thread_ids.begin())];
+                ++thread.evaluations;
+                thread.busy_seconds += timing.latency_seconds + timing.lock_wait_seconds + timing.reduction_seconds;
+            }
+
+            for (auto& thread : telemetry.threads)
+                thread.utilization = telemetry.evaluation_seconds > 0.0 ? thread.busy_seconds / telemetry.evaluation_seconds : 0.0;
+
+            return telemetry;
+        }
+
+        // Keeps the fidelities that fit successive halving: strictly ascending and below the full evaluation
+        auto screening_fidelities(const std::vector<float>& fidelity_schedule) -> std::vector<float> {
+            auto fidelities = std::vector<float>{};
+
+            for (const auto& fidelity : fidelity_schedule) {
+                if (fidelity > 0.0f && fidelity < 1.0f && (fidelities.empty() || fidelity > fidelities.back()))
+                    fidelities.push_back(fidelity);
+                else
+                    std::cerr << "Warning: Ignoring fidelity " << fidelity << ", the schedule has to ascend within (0, 1)." << std::endl;
+            }
+
+            return fidelities;
+        }
+
+        // One scratch per chunk of the executor, allocated once and reused by every epoch
+        auto worker_scratches(const ParallelExecutor& executor, const std::size_t& width, const std::size_t& height) -> std::vector<SimulationScratch> {
+            return std::vector<SimulationScratch>(executor.get_num_threads(), SimulationScratch(width, height));
+        }
+
+        // Successive halving: ranks the population at every fidelity and keeps the best promotion_fraction of it (at least one
+        // candidate) for the next round, best first. Returns the number of evaluations spent.
+        auto screen_population(
+            std::vector<Model>& population,
+            ParallelExecutor& executor,
+            std::vector<SimulationScratch>& scratches,
+            const FidelityCostCallback& cost_callback,
+            const std::vector<float>& fidelities,
+            const float& promotion_fraction
+        ) -> std::size_t {
+            auto evaluations = std::size_t{ 0 };
+            auto costs = std::vector<float>{};
+            auto order = std::vector<std::size_t>{};
+
+            for (const auto& fidelity : fidelities) {
+                if (population.size() <= 1)
+                    break;
+
+                costs.assign(population.size(), std::numeric_limits<float>::infinity());
+
+                executor.execute_chunked(population.begin(), population.end(), [&](const std::size_t& chunk, Model& candidate_model) {
+                    const auto perf_scope = PerfScope(PerfRegion::Evaluation);
+                    const auto lease = ScratchLease(candidate_model, scratches[chunk]);
+                    const auto cost = cost_callback(candidate_model, fidelity);
+
+                    // NaN would break the ordering below, such a candidate simply ranks last
+                    costs[&candidate_model - population.data()] = std::isnan(cost) ? std::numeric_limits<float>::infinity() : cost;
+                });
+
+                evaluations += population.size();
+
+                const auto promoted_count = std::clamp<std::size_t>(
+                    static_cast<std::size_t>(std::ceil(static_cast<float>(population.size()) * promotion_fraction)), 1, population.size());
+
+                // Ties go to the earlier candidate, so the promotion does not depend on thread scheduling
+                order.resize(population.size());
+                std::iota(order.begin(), order.end(), 0);
+                std::partial_sort(order.begin(), order.begin() + static_cast<std::ptrdiff_t>(promoted_count), order.end(), [&](const std::size_t& a, const std::size_t& b) {
+                    return costs[a] < costs[b] || (costs[a] == costs[b] && a < b);
+                });
+
+                auto promoted = std::vector<Model>{};
+                promoted.reserve(promoted_count);
+                for (std::size_t i = 0; i < promoted_count; ++i)
+                    promoted.push_back(std::move(population[order[i]]));
+
+                population = std::move(promoted);
+            }
+
+            return evaluations;
+        }
+    }
+
+    auto ignore_cutoff(std::function<float(Model&)> model_cost_callback) -> CutoffCostCallback {
+        return [model_cost_callback = std::move(model_cost_callback)](Model& model, const float& cutoff) -> std::optional<float> {
+            std::ignore = cutoff;
+            return model_cost_callback(model);
+        };
+    }
+
+    auto evaluation_cost(EvaluationSpec spec) -> CutoffCostCallback {
+        return [spec = std::move(spec)](Model& model, const float& cutoff) -> std::optional<float> {
+            return evaluate(model, spec, cutoff);
+        };
+    }
+
     auto genetic_algorithm_training_hyper(std::function<float(Model&)> model_cost_callback, GeneticAlgorithmTrainingParameters parameters) -> Model {
+        return genetic_algorithm_training_hyper(ignore_cutoff(std::move(model_cost_callback)), std::move(parameters));
+    }
+
+    auto genetic_algorithm_training_hyper(const EvaluationSpec& spec, GeneticAlgorithmTrainingParameters parameters) -> Model {
+        parameters.n_evolution_steps = spec.n_evolution_steps;
+        return genetic_algorithm_training_hyper(evaluation_cost(spec), std::move(parameters));
+    }
+
+    auto genetic_algorithm_training_hyper(CutoffCostCallback model_cost_callback, GeneticAlgorithmTrainingParameters parameters) -> Model {
         const auto n_evolution_steps = parameters.n_evolution_steps;
         const auto population_size = parameters.population_size;
         const auto initial_mutation_strength = parameters.initial_mutation_strength;
@@ -59,21 +258,8 @@ namespace m964 {
         const auto print_interval_epochs = parameters.print_interval_epochs;
 
         auto best_model = Model(parameters.model_width, parameters.model_height);
-
-        std::cout << "Initialized base model with dimensions: " << 4 << "x" << 4 << std::endl;
-
-        best_model.bias_layer.fill([&]() { // Assuming rand_float can be used here effectively
-            return rand_float(-initial_mutation_strength, initial_mutation_strength); // Example: smaller initial weight range
-        });
-
-        best_model.weights.fill([&]() { // Assuming rand_float can be used here effectively
-            return Kernel().fill(rand_float(-initial_mutation_strength, initial_mutation_strength)); // Example: smaller initial weight range
-        });
-
-        auto best_cost = model_cost_callback(best_model);
-        auto prev_cost = best_cost;
-
-        std::cout << "Initial model cost: " << best_cost << std::endl;
+        auto best_cost = 0.0f;
+        auto prev_cost = 0.0f;
 
         auto best_mutex = std::mutex{};
         bool found_new_best_this_epoch = false;
@@ -81,47 +267,170 @@ namespace m964 {
         long long epoch_count = 0;
         float epoch_avg_time = 0.0f;
 
+        auto checkpoint_writer = std::unique_ptr<AsyncCheckpointWriter>{};
+        if (!parameters.checkpoint_path.empty() || !parameters.lineage_log_path.empty())
+            checkpoint_writer = std::make_unique<AsyncCheckpointWriter>(parameters.checkpoint_path, parameters.lineage_log_path, parameters.model_width, parameters.model_height);
+
+        auto checkpoint = std::optional<TrainingCheckpoint>{};
+        if (!parameters.checkpoint_path.empty() && parameters.resume_from_checkpoint)
+            checkpoint = load_checkpoint(parameters.checkpoint_path, parameters.model_width, parameters.model_height);
+
+        if (checkpoint) {
+            best_model = std::move(checkpoint->best_model);
+            best_cost = checkpoint->best_cost;
+            prev_cost = checkpoint->prev_cost;
+            generation_count = checkpoint->generation_count;
+            epoch_count = checkpoint->epoch_count;
+            epoch_avg_time = checkpoint->epoch_avg_time;
+
+            if (!restore_random_state(checkpoint->random_state))
+                std::cerr << "Warning: Checkpoint random state is invalid, resumed run will not be bit-exact." << std::endl;
+
+            std::cout << "Resumed from checkpoint " << parameters.checkpoint_path << " at epoch " << epoch_count << " with cost " << best_cost << std::endl;
+        } else {
+            std::cout << "Initialized base model with dimensions: " << 4 << "x" << 4 << std::endl;
+
+            initialize_model(best_model, initial_mutation_strength);
+
+            best_cost = model_cost_callback(best_model, std::numeric_limits<float>::infinity()).value_or(std::numeric_limits<float>::infinity());
+            prev_cost = best_cost;
+
+            std::cout << "Initial model cost: " << best_cost << std::endl;
+
+            if (checkpoint_writer)
+                checkpoint_writer->submit_lineage({ epoch_count, generation_count, best_cost }, best_model);
+        }
+
+        auto make_checkpoint = [&]() {
+            return TrainingCheckpoint {
+                .best_model = best_model,
+                .best_cost = best_cost,
+                .prev_cost = prev_cost,
+                .generation_count = generation_count,
+                .epoch_count = epoch_count,
+                .epoch_avg_time = epoch_avg_time,
+                .mutation_strength = initial_mutation_strength / std::sqrt(static_cast<float>(generation_count)),
+                .random_state = capture_random_state()
+            };
+        };
+
         std::cout << "\n--- Starting Training ---" << std::endl;
         std::cout << "N_evolution_steps: " << n_evolution_steps
                   << ", Population: " << population_size
                   << ", Target Cost: < " << target_cost_threshold
                   << ", Max Epochs: " << max_epochs << std::endl;
 
+        const auto telemetry_enabled = parameters.telemetry_sink != nullptr;
+        auto candidate_timings = std::vector<CandidateTiming>{};
+
+        const auto fidelities = parameters.screening_cost_callback ? screening_fidelities(parameters.fidelity_schedule) : std::vector<float>{};
+        const auto promotion_fraction = std::clamp(parameters.promotion_fraction, 0.0f, 1.0f);
+
+        ParallelExecutor executor(parameters.thread_count > 0 ? parameters.thread_count : std::thread::hardware_concurrency());
+        auto scratches = worker_scratches(executor, parameters.model_width, parameters.model_height);
+
         while (epoch_count < max_epochs) {
             auto epoch_start_time = std::chrono::high_resolution_clock::now();
 
-            std::vector<Model> current_population(population_size);
-
             const float current_mutation_strength = initial_mutation_strength / std::sqrt(static_cast<float>(generation_count));
 
-            for (int i = 0; i < population_size; ++i) {
-                current_population[i] = best_model;
+            if (telemetry_enabled && perf_counters_enabled())
+                reset_perf_regions();
 
-                current_population[i].bias_layer.apply([&](auto& value) {
-                    value += rand_float(-1.0f, 1.0f) * current_mutation_strength;
-                });
+            // Candidates only carry parameters, each worker lends them its scratch states while it evaluates them
+            auto parent = best_model;
+            parent.release_states();
 
-                current_population[i].weights.apply(KernelOffset{
-                    -current_mutation_strength, current_mutation_strength
-                });
+            std::vector<Model> current_population(population_size, parent);
+
+            {
+                const auto perf_scope = PerfScope(PerfRegion::Mutation);
+
+                for (int i = 0; i < population_size; ++i)
+                    mutate_model(current_population[i], current_mutation_strength);
             }
 
+            const auto screening_start_time = std::chrono::high_resolution_clock::now();
+
+            auto screening_evaluations = std::size_t{ 0 };
+            if (!fidelities.empty())
+                screening_evaluations = screen_population(current_population, executor, scratches, parameters.screening_cost_callback, fidelities, promotion_fraction);
+
+            const auto evaluation_start_time = std::chrono::high_resolution_clock::now();
+
             found_new_best_this_epoch = false;
-            ParallelExecutor executor; // Assuming this is your parallel execution utility
+            auto aborted_count = std::atomic<int>{ 0 };
+            auto cutoff = std::atomic<float>{ best_cost };
+
+            if (telemetry_enabled)
+                candidate_timings.resize(current_population.size());
+
+            executor.execute_chunked(current_population.begin(), current_population.end(), [&](const std::size_t& chunk, Model &candidate_model) {
+                const auto start_time = telemetry_enabled ? std::chrono::high_resolution_clock::now() : std::chrono::high_resolution_clock::time_point{};
+                const auto candidate_cost = [&]() {
+                    const auto perf_scope = PerfScope(PerfRegion::Evaluation);
+                    const auto lease = ScratchLease(candidate_model, scratches[chunk]);
+                    return model_cost_callback(candidate_model, cutoff.load(std::memory_order_relaxed));
+                }();
+
+                // Every candidate owns its slot, so recording needs no synchronization
+                auto* timing = telemetry_enabled ? &candidate_timings[&candidate_model - current_population.data()] : nullptr;
+                if (timing) {
+                    timing->thread = std::this_thread::get_id();
+                    timing->latency_seconds = seconds_since(start_time);
+                    timing->lock_wait_seconds = 0.0;
+                    timing->reduction_seconds = 0.0;
+                }
 
-            executor.execute(current_population.begin(), current_population.end(), [&](Model &candidate_model) {
-                float candidate_cost = model_cost_callback(candidate_model);
+                // An aborted candidate already exceeded the best cost, it never competes for best
+                if (!candidate_cost) {
+                    ++aborted_count;
+                    return;
+                }
 
+                const auto lock_start_time = timing ? std::chrono::high_resolution_clock::now() : std::chrono::high_resolution_clock::time_point{};
                 std::lock_guard<std::mutex> lock(best_mutex);
-                if (candidate_cost < best_cost) {
+                const auto lock_acquired_time = timing ? std::chrono::high_resolution_clock::now() : std::chrono::high_resolution_clock::time_point{};
+
+                if (*candidate_cost < best_cost) {
                     prev_cost = best_cost;
-                    best_cost = candidate_cost;
-                    best_model = candidate_model; // Assumes Model assignment is efficient
+                    best_cost = *candidate_cost;
+                    best_model = candidate_model;
+                    best_model.allocate_states();
                     found_new_best_this_epoch = true;
+                    cutoff.store(best_cost, std::memory_order_relaxed);
+                }
+
+                if (timing) {
+                    timing->lock_wait_seconds = std::chrono::duration<double>(lock_acquired_time - lock_start_time).count();
+                    timing->reduction_seconds = seconds_since(lock_acquired_time);
                 }
             });
 
             auto epoch_end_time = std::chrono::high_resolution_clock::now();
+
+            if (telemetry_enabled) {
+                auto telemetry = summarize_epoch(candidate_timings, evaluation_start_time, epoch_end_time);
+
+                telemetry.epoch = epoch_count;
+                telemetry.generation = generation_count + (found_new_best_this_epoch ? 1 : 0);
+                telemetry.best_cost = best_cost;
+                telemetry.mutation_strength = current_mutation_strength;
+                telemetry.improved = found_new_best_this_epoch;
+                telemetry.aborted_evaluations = static_cast<std::size_t>(aborted_count.load());
+                telemetry.screening_evaluations = screening_evaluations;
+                telemetry.epoch_seconds = std::chrono::duration<double>(epoch_end_time - epoch_start_time).count();
+                telemetry.mutation_seconds = std::chrono::duration<double>(screening_start_time - epoch_start_time).count();
+                telemetry.screening_seconds = std::chrono::duration<double>(evaluation_start_time - screening_start_time).count();
+                telemetry.cells_per_second = telemetry.evaluations_per_second * static_cast<double>(parameters.model_width * parameters.model_height * n_evolution_steps);
+
+                if (perf_counters_enabled()) {
+                    telemetry.perf_counters = true;
+                    telemetry.regions = collect_perf_regions();
+                }
+
+                parameters.telemetry_sink->emit(telemetry);
+            }
             auto epoch_duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(epoch_end_time - epoch_start_time).count();
 
             const double costChangePerEpoch = prev_cost - best_cost;
@@ -133,23 +442,42 @@ namespace m964 {
             if (found_new_best_this_epoch) {
                 ++generation_count;
 
-                printf("Epoch %lld | Gen %lld | New Best Cost: %.6f | Predicted : %lld | Mut.Strength: %.4f | Epoch Time: %lldms | Estimated epoch max time: [ %s ] | *Improvement!*\n",
-                       epoch_count, generation_count, best_cost, predicted_epochs, current_mutation_strength, epoch_duration_ms, formatMilliseconds((max_epochs - epoch_count) * epoch_avg_time).c_str());
+                if (checkpoint_writer)
+                    checkpoint_writer->submit_lineage({ epoch_count, generation_count, best_cost }, best_model);
+
+                printf("Epoch %lld | Gen %lld | New Best Cost: %.6f | Predicted : %lld | Mut.Strength: %.4f | Aborted: %d/%d | Epoch Time: %lldms | Estimated epoch max time: [ %s ] | *Improvement!*\n",
+                       epoch_count, generation_count, best_cost, predicted_epochs, current_mutation_strength, aborted_count.load(), static_cast<int>(current_population.size()), epoch_duration_ms, formatMilliseconds((max_epochs - epoch_count) * epoch_avg_time).c_str());
             } else {
                 if (epoch_count % print_interval_epochs == 0) {
-                    printf("Epoch %lld | Gen %lld | New Best Cost: %.6f | Predicted : %lld | Mut.Strength: %.4f | Epoch Time: %lldms | Estimated epoch max time: [ %s ]\n",
-                           epoch_count, generation_count, best_cost, predicted_epochs, current_mutation_strength, epoch_duration_ms, formatMilliseconds((max_epochs - epoch_count) * epoch_avg_time).c_str());
+                    printf("Epoch %lld | Gen %lld | New Best Cost: %.6f | Predicted : %lld | Mut.Strength: %.4f | Aborted: %d/%d | Epoch Time: %lldms | Estimated epoch max time: [ %s ]\n",
+                           epoch_count, generation_count, best_cost, predicted_epochs, current_mutation_strength, aborted_count.load(), static_cast<int>(current_population.size()), epoch_duration_ms, formatMilliseconds((max_epochs - epoch_count) * epoch_avg_time).c_str());
                 }
             }
 
             ++epoch_count;
 
+            const auto cost_before_callback = best_cost;
+            if (parameters.epoch_callback && parameters.epoch_callback(best_model, best_cost, epoch_count)) {
+                prev_cost = cost_before_callback;
+
+                if (checkpoint_writer)
+                    checkpoint_writer->submit_lineage({ epoch_count, generation_count, best_cost }, best_model);
+            }
+
+            if (checkpoint_writer && parameters.checkpoint_interval_epochs > 0 && epoch_count % parameters.checkpoint_interval_epochs == 0)
+                checkpoint_writer->submit_checkpoint(make_checkpoint());
+
             if (best_cost < target_cost_threshold) {
                 std::cout << "\nTarget cost threshold (" << target_cost_threshold << ") reached at epoch " << epoch_count << "!" << std::endl;
                 break;
             }
         }
 
+        if (checkpoint_writer) {
+            checkpoint_writer->submit_checkpoint(make_checkpoint());
+            checkpoint_writer->flush();
+        }
+
         std::cout << "\n--- Training Finished ---" << std::endl;
         if (epoch_count >= max_epochs && best_cost >= target_cost_threshold) {
             std::cout << "Max epochs (" << max_epochs << ") reached." << std::endl;
@@ -161,4 +489,235 @@ namespace m964 {
 
         return best_model;
     }
-}
\ No newline at end of file
+
+    auto genetic_algorithm_training_successive_halving(FidelityCostCallback model_cost_callback, GeneticAlgorithmTrainingParameters parameters) -> Model {
+        parameters.screening_cost_callback = model_cost_callback;
+
+        return genetic_algorithm_training_hyper([model_cost_callback = std::move(model_cost_callback)](Model& model, const float& cutoff) -> std::optional<float> {
+            std::ignore = cutoff;
+            return model_cost_callback(model, 1.0f);
+        }, std::move(parameters));
+    }
+
+    auto genetic_algorithm_training_steady_state(std::function<float(Model&)> model_cost_callback, GeneticAlgorithmTrainingParameters parameters) -> Model {
+        return genetic_algorithm_training_steady_state(ignore_cutoff(std::move(model_cost_callback)), std::move(parameters));
+    }
+
+    auto genetic_algorithm_training_steady_state(const EvaluationSpec& spec, GeneticAlgorithmTrainingParameters parameters) -> Model {
+        parameters.n_evolution_steps = spec.n_evolution_steps;
+        return genetic_algorithm_training_steady_state(evaluation_cost(spec), std::move(parameters));
+    }
+
+    auto genetic_algorithm_training_steady_state(CutoffCostCallback model_cost_callback, GeneticAlgorithmTrainingParameters parameters) -> Model {
+        const auto initial_mutation_strength = parameters.initial_mutation_strength;
+        const auto target_cost_threshold = parameters.target_cost_threshold;
+        const auto max_evaluations = static_cast<long long>(parameters.max_epochs) * parameters.population_size;
+        const auto print_interval_evaluations = std::max(1, parameters.print_interval_evaluations);
+        const auto thread_count = parameters.thread_count > 0 ? parameters.thread_count : std::thread::hardware_concurrency();
+
+        auto initial_model = Model(parameters.model_width, parameters.model_height);
+        initialize_model(initial_model, initial_mutation_strength);
+
+        auto best_cost = model_cost_callback(initial_model, std::numeric_limits<float>::infinity()).value_or(std::numeric_limits<float>::infinity());
+
+        // The best and the candidates only carry parameters, the workers lend them their scratch states for evaluation
+        initial_model.release_states();
+        auto best_model = std::make_shared<const Model>(std::move(initial_model));
+        long long generation_count = 1;
+
+        // Block mode keeps the best as shared tiles, best_model stays the initial model until the end
+        const auto block_size = parameters.parameter_block_size;
+        auto best_blocks = block_size > 0 ? std::make_shared<const BlockParameters>(*best_model, block_size) : nullptr;
+
+        std::cout << "Initial model cost: " << best_cost << std::endl;
+
+        auto checkpoint_writer = std::unique_ptr<AsyncCheckpointWriter>{};
+        if (!parameters.lineage_log_path.empty()) {
+            checkpoint_writer = std::make_unique<AsyncCheckpointWriter>("", parameters.lineage_log_path, parameters.model_width, parameters.model_height);
+            checkpoint_writer->submit_lineage({ 0, generation_count, best_cost }, *best_model);
+        }
+
+        auto best_mutex = std::mutex{};
+        auto started_evaluations = std::atomic<long long>{ 0 };
+        auto completed_evaluations = std::atomic<long long>{ 0 };
+        auto aborted_evaluations = std::atomic<long long>{ 0 };
+        auto cutoff = std::atomic<float>{ best_cost };
+        auto target_reached = std::atomic<bool>{ false };
+
+        std::cout << "\n--- Starting Steady-State Training ---" << std::endl;
+        std::cout << "N_evolution_steps: " << parameters.n_evolution_steps
+                  << ", Workers: " << thread_count
+                  << ", Target Cost: < " << target_cost_threshold
+                  << ", Max Evaluations: " << max_evaluations << std::endl;
+
+        const auto training_start_time = std::chrono::high_resolution_clock::now();
+        auto interval_start_time = training_start_time;
+
+        // Without epochs every print interval becomes one telemetry record, its state is guarded by best_mutex
+        const auto telemetry_enabled = parameters.telemetry_sink != nullptr;
+        auto interval_timings = std::vector<CandidateTiming>{};
+        auto interval_mutation_seconds = 0.0;
+        auto interval_generation = generation_count;
+        auto interval_aborted = 0LL;
+        long long interval_count = 0;
+
+        auto emit_telemetry = [&](const std::chrono::high_resolution_clock::time_point& now, const float& mutation_strength) {
+            auto telemetry = summarize_epoch(interval_timings, interval_start_time, now);
+
+            telemetry.epoch = interval_count++;
+            telemetry.generation = generation_count;
+            telemetry.best_cost = best_cost;
+            telemetry.mutation_strength = mutation_strength;
+            telemetry.improved = generation_count != interval_generation;
+            telemetry.aborted_evaluations = static_cast<std::size_t>(aborted_evaluations.load() - interval_aborted);
+            telemetry.epoch_seconds = telemetry.evaluation_seconds;
+            telemetry.mutation_seconds = interval_mutation_seconds;
+            telemetry.cells_per_second = telemetry.evaluations_per_second * static_cast<double>(parameters.model_width * parameters.model_height * parameters.n_evolution_steps);
+
+            if (perf_counters_enabled()) {
+                telemetry.perf_counters = true;
+                telemetry.regions = collect_perf_regions();
+                reset_perf_regions();
+            }
+
+            parameters.telemetry_sink->emit(telemetry);
+
+            interval_timings.clear();
+            interval_mutation_seconds = 0.0;
+            interval_generation = generation_count;
+            interval_aborted = aborted_evaluations.load();
+        };
+
+        if (telemetry_enabled && perf_counters_enabled())
+            reset_perf_regions();
+
+        // Every worker pulls the current best, mutates and evaluates it on its own, nobody waits for the slowest candidate
+        auto workers = std::vector<std::size_t>(thread_count);
+        ParallelExecutor executor(thread_count);
+        auto scratches = worker_scratches(executor, parameters.model_width, parameters.model_height);
+
+        executor.execute_chunked(workers.begin(), workers.end(), [&](const std::size_t& chunk, std::size_t&) {
+            auto candidate = Model(parameters.model_width, parameters.model_height);
+            candidate.release_states();
+
+            auto& scratch = scratches[chunk];
+            auto candidate_blocks = std::optional<BlockParameters>{}; // the parameters candidate holds in block mode
+
+            while (!target_reached && started_evaluations.fetch_add(1) < max_evaluations) {
+                auto parent = std::shared_ptr<const Model>{};
+                auto parent_blocks = std::shared_ptr<const BlockParameters>{};
+                auto mutation_strength = 0.0f;
+
+                {
+                    std::lock_guard<std::mutex> lock(best_mutex);
+                    parent = best_model;
+                    parent_blocks = best_blocks;
+                    mutation_strength = initial_mutation_strength / std::sqrt(static_cast<float>(generation_count));
+                }
+
+                const auto mutation_start_time = telemetry_enabled ? std::chrono::high_resolution_clock::now() : std::chrono::high_resolution_clock::time_point{};
+
+                {
+                    const auto perf_scope = PerfScope(PerfRegion::Mutation);
+
+                    if (parent_blocks) {
+                        // Only the tiles that differ from the previous candidate are written into the model
+                        auto blocks = *parent_blocks;
+                        blocks.mutate_random_block(mutation_strength);
+
+                        if (candidate_blocks)
+                            blocks.write_changed_to(candidate, *candidate_blocks);
+                        else
+                            blocks.write_to(candidate);
+
+                        candidate_blocks = std::move(blocks);
+                    } else {
+                        candidate = *parent;
+                        mutate_model(candidate, mutation_strength);
+                    }
+                }
+
+                const auto start_time = telemetry_enabled ? std::chrono::high_resolution_clock::now() : std::chrono::high_resolution_clock::time_point{};
+                const auto candidate_cost = [&]() {
+                    const auto perf_scope = PerfScope(PerfRegion::Evaluation);
+                    const auto lease = ScratchLease(candidate, scratch);
+                    return model_cost_callback(candidate, cutoff.load(std::memory_order_relaxed));
+                }();
+                const auto evaluation = ++completed_evaluations;
+
+                auto timing = CandidateTiming{};
+                if (telemetry_enabled) {
+                    timing.thread = std::this_thread::get_id();
+                    timing.latency_seconds = seconds_since(start_time);
+                }
+
+                if (!candidate_cost)
+                    ++aborted_evaluations;
+
+                const auto lock_start_time = telemetry_enabled ? std::chrono::high_resolution_clock::now() : std::chrono::high_resolution_clock::time_point{};
+                std::lock_guard<std::mutex> lock(best_mutex);
+                const auto lock_acquired_time = telemetry_enabled ? std::chrono::high_resolution_clock::now() : std::chrono::high_resolution_clock::time_point{};
+
+                if (candidate_cost && *candidate_cost < best_cost) {
+                    best_cost = *candidate_cost;
+                    cutoff.store(best_cost, std::memory_order_relaxed);
+                    ++generation_count;
+
+                    if (candidate_blocks)
+                        best_blocks = std::make_shared<const BlockParameters>(*candidate_blocks);
+                    else
+                        best_model = std::make_shared<const Model>(candidate);
+
+                    if (checkpoint_writer)
+                        checkpoint_writer->submit_lineage({ evaluation, generation_count, best_cost }, candidate);
+
+                    if (best_cost < target_cost_threshold)
+                        target_reached = true;
+                }
+
+                if (telemetry_enabled) {
+                    timing.lock_wait_seconds = std::chrono::duration<double>(lock_acquired_time - lock_start_time).count();
+                    timing.reduction_seconds = seconds_since(lock_acquired_time);
+                    interval_timings.push_back(timing);
+                    interval_mutation_seconds += std::chrono::duration<double>(start_time - mutation_start_time).count();
+                }
+
+                if (evaluation % print_interval_evaluations == 0) {
+                    const auto now = std::chrono::high_resolution_clock::now();
+                    const auto interval_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - interval_start_time).count();
+                    const auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - training_start_time).count();
+                    const auto evaluations_per_second = interval_ms > 0 ? 1000.0 * print_interval_evaluations / static_cast<double>(interval_ms) : 0.0;
+                    const auto remaining_ms = static_cast<long long>(static_cast<double>(elapsed_ms) / static_cast<double>(evaluation) * static_cast<double>(max_evaluations - evaluation));
+
+                    if (telemetry_enabled)
+                        emit_telemetry(now, mutation_strength);
+
+                    interval_start_time = now;
+
+                    printf("Evaluations %lld | Gen %lld | Best Cost: %.6f | Mut.Strength: %.4f | Aborted: %lld | Evals/s: %.1f | Estimated max time: [ %s ]\n",
+                           evaluation, generation_count, best_cost, mutation_strength, aborted_evaluations.load(), evaluations_per_second, formatMilliseconds(remaining_ms).c_str());
+                }
+            }
+        });
+
+        // The evaluations after the last print interval
+        if (telemetry_enabled && !interval_timings.empty())
+            emit_telemetry(std::chrono::high_resolution_clock::now(), initial_mutation_strength / std::sqrt(static_cast<float>(generation_count)));
+
+        if (checkpoint_writer)
+            checkpoint_writer->flush();
+
+        std::cout << "\n--- Training Finished ---" << std::endl;
+        if (target_reached)
+            std::cout << "Target cost threshold (" << target_cost_threshold << ") reached." << std::endl;
+        std::cout << "Final best cost: " << best_cost << " after " << completed_evaluations << " evaluations and " << generation_count << " generations." << std::endl;
+
+        auto result = *best_model;
+        result.allocate_states();
+
+        if (best_blocks)
+            best_blocks->write_to(result);
+
+        return result;
+    }
+}
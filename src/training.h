@@ -8,14 +8,37 @@
 #include <random>
 #include <execution>
 #include <mutex>
+#include <atomic>
+#include <thread>
 #include <string>
 #include <iomanip> // Required for std::setfill and std::setw
 #include <sstream> // Required for std::ostringstream
+#include <memory>
+#include <optional>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
 
 #include "model.h"
+#include "checkpoint.h"
+#include "telemetry.h"
+#include "perf_counters.h"
+#include "kernels.h"
+#include "evaluation.h"
+#include "light_cone.h"
+#include "parameter_blocks.h"
+#include "scratch.h"
 #include "parallel_executor.h"
 
 namespace m964 {
+    // Cost callback that receives the cost it has to beat. Costs are expected to accumulate monotonically,
+    // so once the partial cost reaches the cutoff the callback may give up and return std::nullopt.
+    using CutoffCostCallback = std::function<std::optional<float>(Model&, const float&)>;
+
+    // Cost callback evaluated at a fidelity in (0, 1], the fraction of the full evaluation (samples, frames, ...) to spend.
+    // Costs of the same fidelity have to be comparable with each other, a cost at fidelity 1 is the full cost.
+    using FidelityCostCallback = std::function<float(Model&, const float&)>;
+
     struct GeneticAlgorithmTrainingParameters {
         size_t model_width = 8;
         size_t model_height = 8;
@@ -25,10 +48,58 @@ namespace m964 {
         float target_cost_threshold = 0.5f;
         int max_epochs = 100000;
         int print_interval_epochs = 20;
+        int print_interval_evaluations = 1000;
+
+        std::string checkpoint_path = "";
+        int checkpoint_interval_epochs = 100;
+        bool resume_from_checkpoint = true;
+        std::string lineage_log_path = "";
+
+        std::size_t thread_count = 0; // 0 uses std::thread::hardware_concurrency()
+
+        // Invoked after every epoch with the current best model and cost, may replace both and returns true if it did
+        std::function<bool(Model&, float&, const long long&)> epoch_callback = nullptr;
+
+        // Receives per-epoch counters and phase timings, nullptr skips the measurements entirely
+        std::shared_ptr<TelemetrySink> telemetry_sink = nullptr;
+
+        // Successive halving, hyper mode only: when set, every epoch first ranks the candidates with this callback at each
+        // fidelity of fidelity_schedule (ascending, below 1) and only the best promotion_fraction of every round moves on.
+        // The survivors then get the full evaluation of the regular cost callback.
+        FidelityCostCallback screening_cost_callback = nullptr;
+        std::vector<float> fidelity_schedule = { 0.125f, 0.25f, 0.5f };
+        float promotion_fraction = 0.5f;
+
+        // Steady-state mode only: above 0 the candidates are BlockParameters with tiles of this size that share all
+        // unchanged tiles with the parent, and every candidate mutates one tile instead of the whole model
+        std::size_t parameter_block_size = 0;
     };
 
     std::string formatMilliseconds(long long milliseconds);
     double calculate_new_average(double old_average, int old_count, double new_entry);
 
+    auto initialize_model(Model& model, const float& initial_mutation_strength) -> void;
+    auto mutate_model(Model& model, const float& mutation_strength) -> void;
+
+    // mutate_model on the biases and kernels of a tile_width x tile_height tile at a random position, returns the tile
+    auto mutate_model_tile(Model& model, const float& mutation_strength, const std::size_t& tile_width, const std::size_t& tile_height) -> CellRegion;
+
+    auto ignore_cutoff(std::function<float(Model&)> model_cost_callback) -> CutoffCostCallback;
+
+    // evaluate() on a copy of the spec, the overloads taking an EvaluationSpec also use its n_evolution_steps
+    auto evaluation_cost(EvaluationSpec spec) -> CutoffCostCallback;
+
     auto genetic_algorithm_training_hyper(std::function<float(Model&)> model_cost_callback, GeneticAlgorithmTrainingParameters parameters) -> Model;
+    auto genetic_algorithm_training_hyper(CutoffCostCallback model_cost_callback, GeneticAlgorithmTrainingParameters parameters) -> Model;
+    auto genetic_algorithm_training_hyper(const EvaluationSpec& spec, GeneticAlgorithmTrainingParameters parameters) -> Model;
+
+    // Hyper mode with successive halving on a single callback: screens with it at the fidelity_schedule and evaluates the survivors at fidelity 1
+    auto genetic_algorithm_training_successive_halving(FidelityCostCallback model_cost_callback, GeneticAlgorithmTrainingParameters parameters) -> Model;
+
+    // Asynchronous (1 + 1) evolution without an epoch barrier, runs max_epochs * population_size evaluations in total.
+    // Checkpointing and epoch_callback are epoch based and therefore not used in this mode. The telemetry_sink gets one
+    // record per print_interval_evaluations evaluations instead, with the interval index as its epoch.
+    auto genetic_algorithm_training_steady_state(std::function<float(Model&)> model_cost_callback, GeneticAlgorithmTrainingParameters parameters) -> Model;
+    auto genetic_algorithm_training_steady_state(CutoffCostCallback model_cost_callback, GeneticAlgorithmTrainingParameters parameters) -> Model;
+    auto genetic_algorithm_training_steady_state(const EvaluationSpec& spec, GeneticAlgorithmTrainingParameters parameters) -> Model;
 }
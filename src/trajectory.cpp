@@ -0,0 +1,494 @@
+#include "trajectory.h"
+
+#include <cstring>
+#include <algorithm>
+#include <iostream>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace m964 {
+    namespace {
+        constexpr std::uint32_t TRAJECTORY_VERSION = 1;
+
+        constexpr std::size_t LZ_MIN_MATCH = 4;
+        constexpr std::size_t LZ_LAST_LITERALS = 5;
+        constexpr std::size_t LZ_MAX_OFFSET = 65535;
+        constexpr std::uint32_t LZ_HASH_BITS = 14;
+        constexpr std::uint32_t LZ_NO_POSITION = 0xffffffffu;
+
+        // magic, version, keyframe interval, width, height
+        constexpr std::size_t TRAJECTORY_HEADER_SIZE = 8 + 4 + 4 + 8 + 8;
+        // frame count, index offset, magic
+        constexpr std::size_t TRAJECTORY_TRAILER_SIZE = 8 + 8 + 8;
+        // offset, compressed size, keyframe flag
+        constexpr std::size_t TRAJECTORY_INDEX_ENTRY_SIZE = 8 + 4 + 1;
+        // keyframe flag, compressed size
+        constexpr std::size_t TRAJECTORY_FRAME_HEADER_SIZE = 1 + 4;
+
+        auto read32(const std::uint8_t* data) -> std::uint32_t {
+            std::uint32_t value;
+            std::memcpy(&value, data, sizeof(value));
+            return value;
+        }
+
+        template<typename T>
+        auto load(const std::uint8_t* data) -> T {
+            T value;
+            std::memcpy(&value, data, sizeof(T));
+            return value;
+        }
+
+        template<typename T>
+        auto write_value(std::ostream& stream, const T& value) -> void {
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        auto write_length(std::vector<std::uint8_t>& destination, std::size_t length) -> void {
+            while (length >= 255) {
+                destination.push_back(255);
+                length -= 255;
+            }
+
+            destination.push_back(static_cast<std::uint8_t>(length));
+        }
+
+        auto read_length(const std::uint8_t* source, const std::size_t& size, std::size_t& position, std::size_t& length) -> bool {
+            std::uint8_t byte;
+
+            do {
+                if (position >= size)
+                    return false;
+
+                byte = source[position++];
+                length += byte;
+            } while (byte == 255);
+
+            return true;
+        }
+
+        auto emit_literals(std::vector<std::uint8_t>& destination, const std::uint8_t* literals, const std::size_t& count, const std::size_t& match_length) -> void {
+            const auto match_code = match_length >= LZ_MIN_MATCH ? match_length - LZ_MIN_MATCH : 0;
+            const auto token = static_cast<std::uint8_t>((std::min<std::size_t>(count, 15) << 4) | std::min<std::size_t>(match_code, 15));
+
+            destination.push_back(token);
+
+            if (count >= 15)
+                write_length(destination, count - 15);
+
+            destination.insert(destination.end(), literals, literals + count);
+        }
+    }
+
+    auto shuffle_byte_planes(const std::uint32_t* words, const std::size_t& count, std::uint8_t* planes) -> void {
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto word = words[i];
+            planes[i] = static_cast<std::uint8_t>(word);
+            planes[count + i] = static_cast<std::uint8_t>(word >> 8);
+            planes[2 * count + i] = static_cast<std::uint8_t>(word >> 16);
+            planes[3 * count + i] = static_cast<std::uint8_t>(word >> 24);
+        }
+    }
+
+    auto unshuffle_byte_planes(const std::uint8_t* planes, const std::size_t& count, std::uint32_t* words) -> void {
+        for (std::size_t i = 0; i < count; ++i) {
+            words[i] = static_cast<std::uint32_t>(planes[i])
+                | (static_cast<std::uint32_t>(planes[count + i]) << 8)
+                | (static_cast<std::uint32_t>(planes[2 * count + i]) << 16)
+                | (static_cast<std::uint32_t>(planes[3 * count + i]) << 24);
+        }
+    }
+
+    auto lz_compress(const std::uint8_t* source, const std::size_t& size, std::vector<std::uint8_t>& destination) -> void {
+        destination.clear();
+        destination.reserve(size / 2 + 16);
+
+        auto table = std::vector<std::uint32_t>(std::size_t{1} << LZ_HASH_BITS, LZ_NO_POSITION);
+
+        const auto limit = size > LZ_LAST_LITERALS + LZ_MIN_MATCH ? size - LZ_LAST_LITERALS : 0;
+        std::size_t anchor = 0;
+        std::size_t position = 0;
+
+        while (position + LZ_MIN_MATCH <= limit) {
+            const auto sequence = read32(source + position);
+            const auto hash = (sequence * 2654435761u) >> (32 - LZ_HASH_BITS);
+            const auto reference = table[hash];
+
+            table[hash] = static_cast<std::uint32_t>(position);
+
+            if (reference == LZ_NO_POSITION || position - reference > LZ_MAX_OFFSET || read32(source + reference) != sequence) {
+                ++position;
+                continue;
+            }
+
+            auto length = LZ_MIN_MATCH;
+            while (position + length < limit && source[reference + length] == source[position + length])
+                ++length;
+
+            const auto offset = position - reference;
+
+            emit_literals(destination, source + anchor, position - anchor, length);
+            destination.push_back(static_cast<std::uint8_t>(offset));
+            destination.push_back(static_cast<std::uint8_t>(offset >> 8));
+
+            if (length - LZ_MIN_MATCH >= 15)
+                write_length(destination, length - LZ_MIN_MATCH - 15);
+
+            position += length;
+            anchor = position;
+        }
+
+        emit_literals(destination, source + anchor, size - anchor, 0);
+    }
+
+    auto lz_decompress(const std::uint8_t* source, const std::size_t& size, std::uint8_t* destination, const std::size_t& destination_size) -> bool {
+        std::size_t input = 0;
+        std::size_t output = 0;
+
+        while (input < size) {
+            const auto token = source[input++];
+
+            auto literals = static_cast<std::size_t>(token >> 4);
+            if (literals == 15 && !read_length(source, size, input, literals))
+                return false;
+
+            if (input + literals > size || output + literals > destination_size)
+                return false;
+
+            if (literals > 0)
+                std::memcpy(destination + output, source + input, literals);
+
+            input += literals;
+            output += literals;
+
+            // The last sequence carries literals only
+            if (input == size)
+                return output == destination_size;
+
+            if (input + 2 > size)
+                return false;
+
+            const auto offset = static_cast<std::size_t>(source[input]) | (static_cast<std::size_t>(source[input + 1]) << 8);
+            input += 2;
+
+            auto length = static_cast<std::size_t>(token & 15);
+            if (length == 15 && !read_length(source, size, input, length))
+                return false;
+
+            length += LZ_MIN_MATCH;
+
+            if (offset == 0 || offset > output || output + length > destination_size)
+                return false;
+
+            // Overlapping copies repeat the last `offset` bytes, so copy forward one byte at a time
+            for (std::size_t i = 0; i < length; ++i, ++output)
+                destination[output] = destination[output - offset];
+        }
+
+        return false;
+    }
+
+    TrajectoryRecorder::TrajectoryRecorder(
+        const std::string& file_name,
+        const std::size_t& width,
+        const std::size_t& height,
+        const TrajectoryRecorderParameters& parameters
+    ) : stream(file_name, std::ios::binary | std::ios::trunc),
+        width(width),
+        height(height),
+        parameters(parameters),
+        recorded_frames(0),
+        stopping(false)
+    {
+        if (this->parameters.keyframe_interval == 0)
+            this->parameters.keyframe_interval = 1;
+
+        if (this->parameters.queue_capacity == 0)
+            this->parameters.queue_capacity = 1;
+
+        if (!stream) {
+            std::cerr << "Error [TrajectoryRecorder]: Could not open " << file_name << " for writing." << std::endl;
+            return;
+        }
+
+        stream.write(TRAJECTORY_FILE_MAGIC, sizeof(TRAJECTORY_FILE_MAGIC));
+        write_value<std::uint32_t>(stream, TRAJECTORY_VERSION);
+        write_value<std::uint32_t>(stream, static_cast<std::uint32_t>(this->parameters.keyframe_interval));
+        write_value<std::uint64_t>(stream, width);
+        write_value<std::uint64_t>(stream, height);
+
+        worker = std::thread([this]() { run(); });
+    }
+
+    TrajectoryRecorder::~TrajectoryRecorder() {
+        close();
+    }
+
+    auto TrajectoryRecorder::is_open() const -> bool {
+        return stream.is_open() && stream.good();
+    }
+
+    auto TrajectoryRecorder::record(const Layer& state) -> void {
+        if (state.get_width() != width || state.get_height() != height) {
+            std::cerr << "Error [TrajectoryRecorder::record]: State dimensions do not match the trajectory." << std::endl;
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        if (stopping || !worker.joinable())
+            return;
+
+        slot_available.wait(lock, [&]() { return queue.size() < parameters.queue_capacity; });
+
+        auto frame = std::vector<float>{};
+        if (!buffer_pool.empty()) {
+            frame = std::move(buffer_pool.back());
+            buffer_pool.pop_back();
+        }
+
+        frame.assign(state.data(), state.data() + state.size());
+        queue.push_back(std::move(frame));
+        lock.unlock();
+
+        frame_available.notify_one();
+    }
+
+    auto TrajectoryRecorder::close() -> void {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+
+        frame_available.notify_one();
+
+        if (worker.joinable())
+            worker.join();
+
+        if (!stream.is_open())
+            return;
+
+        const auto index_offset = static_cast<std::uint64_t>(stream.tellp());
+
+        for (const auto& entry : index) {
+            write_value(stream, entry.offset);
+            write_value(stream, entry.compressed_size);
+            write_value(stream, entry.keyframe);
+        }
+
+        write_value<std::uint64_t>(stream, index.size());
+        write_value<std::uint64_t>(stream, index_offset);
+        stream.write(TRAJECTORY_INDEX_MAGIC, sizeof(TRAJECTORY_INDEX_MAGIC));
+        stream.close();
+    }
+
+    auto TrajectoryRecorder::write_frame(const std::vector<float>& frame, std::vector<std::uint8_t>& planes, std::vector<std::uint8_t>& compressed) -> void {
+        const auto count = frame.size();
+        const auto keyframe = recorded_frames % parameters.keyframe_interval == 0;
+
+        words.resize(count);
+        std::memcpy(words.data(), frame.data(), count * sizeof(float));
+
+        if (keyframe) {
+            previous = words;
+        } else {
+            for (std::size_t i = 0; i < count; ++i) {
+                const auto bits = words[i];
+                words[i] ^= previous[i];
+                previous[i] = bits;
+            }
+        }
+
+        planes.resize(count * sizeof(std::uint32_t));
+        shuffle_byte_planes(words.data(), count, planes.data());
+        lz_compress(planes.data(), planes.size(), compressed);
+
+        const auto entry = FrameIndexEntry{
+            static_cast<std::uint64_t>(stream.tellp()),
+            static_cast<std::uint32_t>(compressed.size()),
+            static_cast<std::uint8_t>(keyframe ? 1 : 0)
+        };
+
+        write_value(stream, entry.keyframe);
+        write_value(stream, entry.compressed_size);
+        stream.write(reinterpret_cast<const char*>(compressed.data()), static_cast<std::streamsize>(compressed.size()));
+
+        index.push_back(entry);
+        ++recorded_frames;
+    }
+
+    auto TrajectoryRecorder::run() -> void {
+        auto planes = std::vector<std::uint8_t>{};
+        auto compressed = std::vector<std::uint8_t>{};
+
+        std::unique_lock<std::mutex> lock(mutex);
+
+        while (true) {
+            frame_available.wait(lock, [&]() { return stopping || !queue.empty(); });
+
+            if (queue.empty())
+                break;
+
+            auto frame = std::move(queue.front());
+            queue.pop_front();
+            lock.unlock();
+            slot_available.notify_all();
+
+            write_frame(frame, planes, compressed);
+
+            lock.lock();
+            buffer_pool.push_back(std::move(frame));
+        }
+    }
+
+    TrajectoryReader::TrajectoryReader(
+        const std::string& file_name
+    ) : mapping(nullptr),
+        mapping_size(0),
+        width(0),
+        height(0),
+        current_step(0),
+        has_current(false)
+    {
+        const auto fd = ::open(file_name.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cerr << "Error [TrajectoryReader]: Could not open " << file_name << std::endl;
+            return;
+        }
+
+        struct stat info{};
+        if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < TRAJECTORY_HEADER_SIZE + TRAJECTORY_TRAILER_SIZE) {
+            std::cerr << "Error [TrajectoryReader]: " << file_name << " is not a complete trajectory." << std::endl;
+            ::close(fd);
+            return;
+        }
+
+        mapping_size = static_cast<std::size_t>(info.st_size);
+        auto* mapped = ::mmap(nullptr, mapping_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+
+        if (mapped == MAP_FAILED) {
+            std::cerr << "Error [TrajectoryReader]: Could not map " << file_name << std::endl;
+            mapping_size = 0;
+            return;
+        }
+
+        mapping = static_cast<const std::uint8_t*>(mapped);
+
+        const auto* trailer = mapping + mapping_size - TRAJECTORY_TRAILER_SIZE;
+        const auto frame_count = load<std::uint64_t>(trailer);
+        const auto index_offset = load<std::uint64_t>(trailer + 8);
+
+        const auto valid = std::memcmp(mapping, TRAJECTORY_FILE_MAGIC, sizeof(TRAJECTORY_FILE_MAGIC)) == 0
+            && load<std::uint32_t>(mapping + 8) == TRAJECTORY_VERSION
+            && std::memcmp(trailer + 16, TRAJECTORY_INDEX_MAGIC, sizeof(TRAJECTORY_INDEX_MAGIC)) == 0
+            && index_offset + frame_count * TRAJECTORY_INDEX_ENTRY_SIZE + TRAJECTORY_TRAILER_SIZE == mapping_size;
+
+        if (!valid) {
+            std::cerr << "Error [TrajectoryReader]: " << file_name << " is truncated or not a trajectory." << std::endl;
+            return;
+        }
+
+        width = load<std::uint64_t>(mapping + 16);
+        height = load<std::uint64_t>(mapping + 24);
+
+        index.reserve(frame_count);
+        for (std::uint64_t i = 0; i < frame_count; ++i) {
+            const auto* entry = mapping + index_offset + i * TRAJECTORY_INDEX_ENTRY_SIZE;
+
+            const auto frame = FrameIndexEntry{
+                load<std::uint64_t>(entry),
+                load<std::uint32_t>(entry + 8),
+                entry[12]
+            };
+
+            if (frame.offset + TRAJECTORY_FRAME_HEADER_SIZE + frame.compressed_size > index_offset) {
+                std::cerr << "Error [TrajectoryReader]: " << file_name << " has a corrupted frame index." << std::endl;
+                index.clear();
+                return;
+            }
+
+            index.push_back(frame);
+        }
+    }
+
+    TrajectoryReader::~TrajectoryReader() {
+        if (mapping != nullptr)
+            ::munmap(const_cast<std::uint8_t*>(mapping), mapping_size);
+    }
+
+    auto TrajectoryReader::is_open() const -> bool {
+        return mapping != nullptr && width > 0 && height > 0;
+    }
+
+    auto TrajectoryReader::get_width() const -> std::size_t {
+        return width;
+    }
+
+    auto TrajectoryReader::get_height() const -> std::size_t {
+        return height;
+    }
+
+    auto TrajectoryReader::frame_count() const -> std::size_t {
+        return index.size();
+    }
+
+    auto TrajectoryReader::apply_frame(const std::size_t& step) -> bool {
+        const auto& entry = index[step];
+        const auto count = width * height;
+
+        planes.resize(count * sizeof(std::uint32_t));
+        delta.resize(count);
+
+        const auto* payload = mapping + entry.offset + TRAJECTORY_FRAME_HEADER_SIZE;
+        if (!lz_decompress(payload, entry.compressed_size, planes.data(), planes.size())) {
+            std::cerr << "Error [TrajectoryReader]: Frame " << step << " is corrupted." << std::endl;
+            has_current = false;
+            return false;
+        }
+
+        if (entry.keyframe) {
+            current.resize(count);
+            unshuffle_byte_planes(planes.data(), count, current.data());
+        } else {
+            unshuffle_byte_planes(planes.data(), count, delta.data());
+
+            for (std::size_t i = 0; i < count; ++i)
+                current[i] ^= delta[i];
+        }
+
+        current_step = step;
+        has_current = true;
+        return true;
+    }
+
+    auto TrajectoryReader::read(const std::size_t& step, Layer& state) -> bool {
+        if (!is_open() || step >= index.size())
+            return false;
+
+        if (state.get_width() != width || state.get_height() != height) {
+            std::cerr << "Error [TrajectoryReader::read]: Layer dimensions do not match the trajectory." << std::endl;
+            return false;
+        }
+
+        auto keyframe = step;
+        while (!index[keyframe].keyframe && keyframe > 0)
+            --keyframe;
+
+        if (!index[keyframe].keyframe)
+            return false;
+
+        // Sequential playback continues from the last decoded frame instead of the keyframe
+        auto first = keyframe;
+        if (has_current && current_step >= keyframe && current_step <= step)
+            first = current_step + 1;
+
+        for (auto frame = first; frame <= step; ++frame)
+            if (!apply_frame(frame))
+                return false;
+
+        std::memcpy(state.data(), current.data(), current.size() * sizeof(float));
+        return true;
+    }
+}
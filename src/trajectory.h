@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "layer.h"
+
+namespace m964 {
+    constexpr char TRAJECTORY_FILE_MAGIC[8] = { 'M', '9', '6', '4', 'T', 'R', 'A', 'J' };
+    constexpr char TRAJECTORY_INDEX_MAGIC[8] = { 'M', '9', '6', '4', 'T', 'I', 'D', 'X' };
+
+    // Byte-plane shuffle of count words: all lowest bytes first, then the next plane, ... Unchanged exponents and
+    // signs of an XOR delta become long zero runs that the LZ stage collapses. planes holds 4 * count bytes.
+    auto shuffle_byte_planes(const std::uint32_t* words, const std::size_t& count, std::uint8_t* planes) -> void;
+    auto unshuffle_byte_planes(const std::uint8_t* planes, const std::size_t& count, std::uint32_t* words) -> void;
+
+    // Minimal LZ77 block codec (LZ4-style sequences: literal run, 16 bit offset, match length)
+    auto lz_compress(const std::uint8_t* source, const std::size_t& size, std::vector<std::uint8_t>& destination) -> void;
+    auto lz_decompress(const std::uint8_t* source, const std::size_t& size, std::uint8_t* destination, const std::size_t& destination_size) -> bool;
+
+    struct TrajectoryRecorderParameters {
+        std::size_t keyframe_interval = 64;
+        std::size_t queue_capacity = 32;
+    };
+
+    // Streams every recorded state of a rollout to a file. Each frame is XORed against the previous one,
+    // byte-plane shuffled and LZ compressed on a background thread, every keyframe_interval frames a
+    // self-contained keyframe is written. The frame index is appended when the recorder is closed.
+    class TrajectoryRecorder {
+        private:
+            struct FrameIndexEntry {
+                std::uint64_t offset;
+                std::uint32_t compressed_size;
+                std::uint8_t keyframe;
+            };
+
+            std::ofstream stream;
+            std::size_t width;
+            std::size_t height;
+            TrajectoryRecorderParameters parameters;
+
+            std::vector<FrameIndexEntry> index;
+            std::vector<std::uint32_t> previous;
+            std::vector<std::uint32_t> words;
+            std::size_t recorded_frames;
+
+            std::deque<std::vector<float>> queue;
+            std::vector<std::vector<float>> buffer_pool;
+            bool stopping;
+
+            std::mutex mutex;
+            std::condition_variable frame_available;
+            std::condition_variable slot_available;
+            std::thread worker;
+
+            auto run() -> void;
+            auto write_frame(const std::vector<float>& frame, std::vector<std::uint8_t>& planes, std::vector<std::uint8_t>& compressed) -> void;
+
+        public:
+            TrajectoryRecorder(const std::string& file_name, const std::size_t& width, const std::size_t& height, const TrajectoryRecorderParameters& parameters = {});
+            ~TrajectoryRecorder();
+
+            TrajectoryRecorder(const TrajectoryRecorder&) = delete;
+            auto operator=(const TrajectoryRecorder&) -> TrajectoryRecorder& = delete;
+
+            [[nodiscard]] auto is_open() const -> bool;
+
+            // Blocks only if the encoder falls queue_capacity frames behind, frames are never dropped
+            auto record(const Layer& state) -> void;
+
+            // Flushes pending frames and writes the frame index, called by the destructor
+            auto close() -> void;
+    };
+
+    // Memory-maps a recorded trajectory, any step decodes from the nearest preceding keyframe
+    class TrajectoryReader {
+        private:
+            const std::uint8_t* mapping;
+            std::size_t mapping_size;
+
+            std::size_t width;
+            std::size_t height;
+
+            struct FrameIndexEntry {
+                std::uint64_t offset;
+                std::uint32_t compressed_size;
+                std::uint8_t keyframe;
+            };
+
+            std::vector<FrameIndexEntry> index;
+
+            std::vector<std::uint32_t> current;
+            std::vector<std::uint32_t> delta;
+            std::vector<std::uint8_t> planes;
+            std::size_t current_step;
+            bool has_current;
+
+            auto apply_frame(const std::size_t& step) -> bool;
+
+        public:
+            explicit TrajectoryReader(const std::string& file_name);
+            ~TrajectoryReader();
+
+            TrajectoryReader(const TrajectoryReader&) = delete;
+            auto operator=(const TrajectoryReader&) -> TrajectoryReader& = delete;
+
+            [[nodiscard]] auto is_open() const -> bool;
+            [[nodiscard]] auto get_width() const -> std::size_t;
+            [[nodiscard]] auto get_height() const -> std::size_t;
+            [[nodiscard]] auto frame_count() const -> std::size_t;
+
+            auto read(const std::size_t& step, Layer& state) -> bool;
+    };
+}
@@ -1,18 +1,25 @@
 #include "utils.h"
 
 namespace m964 {
+    // One engine per thread, so cost callbacks running on worker threads never race
+    // with the mutation loop, and the training thread's state can be checkpointed.
+    auto random_engine() -> std::mt19937& {
+        thread_local std::mt19937 gen(std::random_device{}());
+        return gen;
+    }
+
+    auto seed_random(const std::uint32_t& seed) -> void {
+        random_engine().seed(seed);
+    }
+
     auto rand_int(const int& min, const int& max) -> int {
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
         std::uniform_int_distribution<int> dist(min, max);
-        return dist(gen);
+        return dist(random_engine());
     }
 
     auto rand_float(const float& min, const float& max) -> float {
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
         std::uniform_real_distribution<float> dist(min, max);
-        return dist(gen);
+        return dist(random_engine());
     }
 
     auto PlainValue::operator()(const float& x, const float& y) const -> float {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <random>
 
 #include "kernel.h"
@@ -9,6 +10,9 @@
 #define EULER_NUMBER_L 2.71828182845904523536
 
 namespace m964 {
+    auto random_engine() -> std::mt19937&;
+    auto seed_random(const std::uint32_t& seed) -> void;
+
     auto rand_int(const int& min, const int& max) -> int;
 
     auto rand_float(const float& min, const float& max) -> float;